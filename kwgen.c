@@ -0,0 +1,391 @@
+// kwgen.c  (build: gcc -O2 -o kwgen kwgen.c)
+// Generates the SIMPLE word matchers from keywords.txt:
+//
+//     ./kwgen keywords.txt > wordclass.h
+//     ./kwgen --dfa keywords.txt > lookup.h
+//
+// classify_word() in wordclass.h answers BOOL / DATATYPE / KEYWORD /
+// RESERVED / NOISE / IDENTIFIER with one probe of a perfect hash over
+// (length, first, second and last letter), after a length and first-letter
+// prefilter. Case folding is done on the fly while comparing, so callers
+// pass the lexeme straight from the source buffer.
+//
+// lookupKeyword() in lookup.h keeps the old hand-written DFA's contract
+// (0 = none, 1 = keyword or datatype, 2 = reserved, 3 = noise; booleans
+// are not words there) as a minimized table-driven DFA. Before printing,
+// the generator runs the tables it built over every word, every prefix and
+// every one-letter extension of one, and refuses to emit a DFA that
+// disagrees with the word list. That only proves the tables match
+// keywords.txt; `./simple_bench lookup` checks the emitted header against
+// the hand-written DFA it replaced (lookup_goto.h). The lexer itself only
+// uses wordclass.h; lookup.h is kept for the lookupKeyword() API.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <strings.h>
+
+#define KW_MAX_WORDS 256
+#define KW_MAX_LEN   31
+#define KW_MAX_TABLE 1024
+#define KW_MAX_STATES 1024
+
+static const char *class_names[] = { "ident", "bool", "datatype", "keyword", "reserved", "noise" };
+static const char *class_enums[] = { "WC_IDENT", "WC_BOOL", "WC_DATATYPE", "WC_KEYWORD", "WC_RESERVED", "WC_NOISE" };
+#define KW_NCLASSES (int)(sizeof(class_names) / sizeof(class_names[0]))
+
+typedef struct {
+    char word[KW_MAX_LEN + 1];
+    int len;
+    int cls;
+} KwWord;
+
+static KwWord words[KW_MAX_WORDS];
+static int nwords;
+
+static int class_index(const char *name) {
+    for (int i = 1; i < KW_NCLASSES; ++i)
+        if (strcmp(name, class_names[i]) == 0) return i;
+    return -1;
+}
+
+// read "<class> <word>" lines; '#' starts a comment. Returns 0 on a bad file.
+static int read_spec(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) { perror(path); return 0; }
+    char line[256];
+    int lineno = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineno++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char cls[32], *p = line;
+        int used = 0;
+        if (sscanf(p, "%31s%n", cls, &used) != 1) continue;   // blank line
+        p += used;
+        while (*p == ' ' || *p == '\t') p++;
+        size_t n = strcspn(p, "\r\n");
+        while (n > 0 && (p[n - 1] == ' ' || p[n - 1] == '\t')) n--;
+
+        int c = class_index(cls);
+        if (c < 0) { fprintf(stderr, "%s:%d: unknown class '%s'\n", path, lineno, cls); fclose(f); return 0; }
+        if (n == 0 || n > KW_MAX_LEN) { fprintf(stderr, "%s:%d: bad word\n", path, lineno); fclose(f); return 0; }
+        for (size_t i = 0; i < n; ++i) {
+            // one inner blank is allowed, for "to do"
+            if (islower((unsigned char)p[i]) || (p[i] == ' ' && i > 0 && i + 1 < n && p[i - 1] != ' ')) continue;
+            fprintf(stderr, "%s:%d: words are lowercase letters\n", path, lineno);
+            fclose(f);
+            return 0;
+        }
+        if (nwords == KW_MAX_WORDS) { fprintf(stderr, "%s: too many words\n", path); fclose(f); return 0; }
+        KwWord *w = &words[nwords];
+        memcpy(w->word, p, n);
+        w->word[n] = '\0';
+        w->len = (int)n;
+        w->cls = c;
+        for (int k = 0; k < nwords; ++k)
+            if (strcmp(words[k].word, w->word) == 0) {
+                fprintf(stderr, "%s:%d: '%s' listed twice\n", path, lineno, w->word);
+                fclose(f);
+                return 0;
+            }
+        nwords++;
+    }
+    fclose(f);
+    return 1;
+}
+
+/* must match wc_hash() in the generated header */
+static unsigned kw_hash(const KwWord *w, const unsigned k[4], unsigned mask) {
+    unsigned c0 = (unsigned char)w->word[0], c1 = (unsigned char)w->word[1];
+    unsigned cl = (unsigned char)w->word[w->len - 1];
+    return (c0 * k[0] + c1 * k[1] + cl * k[2] + (unsigned)w->len * k[3]) & mask;
+}
+
+// smallest table (at least twice the word count) with a collision-free
+// multiplier set; returns the table size, or 0 if none was found
+static unsigned find_hash(unsigned k[4]) {
+    static signed char used[KW_MAX_TABLE];
+    unsigned size = 1;
+    while (size < 2u * (unsigned)nwords) size <<= 1;
+    for (; size <= KW_MAX_TABLE; size <<= 1) {
+        for (k[0] = 1; k[0] < 32; ++k[0])
+        for (k[1] = 0; k[1] < 32; ++k[1])
+        for (k[2] = 0; k[2] < 32; ++k[2])
+        for (k[3] = 0; k[3] < 8; ++k[3]) {
+            memset(used, 0, size);
+            int w = 0;
+            for (; w < nwords; ++w) {
+                unsigned h = kw_hash(&words[w], k, size - 1);
+                if (used[h]) break;
+                used[h] = 1;
+            }
+            if (w == nwords) return size;
+        }
+    }
+    return 0;
+}
+
+static void emit_header(const char *spec, const unsigned k[4], unsigned size) {
+    int minlen = KW_MAX_LEN, maxlen = 0;
+    unsigned long first = 0;
+    for (int w = 0; w < nwords; ++w) {
+        if (words[w].len < minlen) minlen = words[w].len;
+        if (words[w].len > maxlen) maxlen = words[w].len;
+        first |= 1ul << (words[w].word[0] - 'a');
+    }
+
+    printf("// SIMPLE word classifier. Generated by kwgen from %s - do not edit;\n", spec);
+    printf("// change the word list and run: ./kwgen %s > wordclass.h\n", spec);
+    printf("//\n");
+    printf("// classify_word() takes an identifier-shaped lexeme (letters, digits, '_')\n");
+    printf("// in any case and returns its class with a single hash probe.\n\n");
+    printf("#ifndef WORDCLASS_H\n#define WORDCLASS_H\n\n");
+    printf("#include <stddef.h>\n#include <stdint.h>\n\n");
+    printf("typedef enum {\n    ");
+    for (int c = 0; c < KW_NCLASSES; ++c) printf("%s%s", class_enums[c], c + 1 < KW_NCLASSES ? ", " : "\n");
+    printf("} WordClass;\n\n");
+    printf("#define WC_MIN_LEN %d\n#define WC_MAX_LEN %d\n", minlen, maxlen);
+    printf("#define WC_FIRST_LETTERS 0x%07lxu   // bit c-'a' set when a word starts with c\n\n", first);
+
+    printf("static const struct {\n    char word[WC_MAX_LEN + 1];\n    uint8_t len;\n    uint8_t cls;\n} wc_table[%u] = {\n", size);
+    for (unsigned h = 0; h < size; ++h) {
+        int w = 0;
+        while (w < nwords && kw_hash(&words[w], k, size - 1) != h) w++;
+        if (w == nwords) continue;
+        printf("    [%3u] = { \"%s\", %d, %s },\n", h, words[w].word, words[w].len, class_enums[words[w].cls]);
+    }
+    printf("};\n\n");
+
+    printf("static inline unsigned wc_hash(unsigned c0, unsigned c1, unsigned cl, size_t len) {\n");
+    printf("    return (c0 * %uu + c1 * %uu + cl * %uu + (unsigned)len * %uu) & %uu;\n", k[0], k[1], k[2], k[3], size - 1);
+    printf("}\n\n");
+
+    printf("/* '|0x20' folds A-Z onto a-z and leaves digits alone; '_' folds to 0x7f,\n");
+    printf("   which no word contains, so it can never match by accident */\n");
+    printf("static inline WordClass classify_word(const char *s, size_t len) {\n");
+    printf("    if (len < WC_MIN_LEN || len > WC_MAX_LEN) return WC_IDENT;\n");
+    printf("    unsigned c0 = (unsigned char)s[0] | 0x20u;\n");
+    printf("    if (c0 - 'a' >= 26u || !((WC_FIRST_LETTERS >> (c0 - 'a')) & 1u)) return WC_IDENT;\n");
+    printf("    unsigned h = wc_hash(c0, (unsigned char)s[1] | 0x20u, (unsigned char)s[len - 1] | 0x20u, len);\n");
+    printf("    if (wc_table[h].len != len) return WC_IDENT;\n");
+    printf("    for (size_t i = 0; i < len; ++i)\n");
+    printf("        if (((unsigned char)s[i] | 0x20u) != (unsigned char)wc_table[h].word[i]) return WC_IDENT;\n");
+    printf("    return (WordClass)wc_table[h].cls;\n");
+    printf("}\n\n");
+    printf("#endif // WORDCLASS_H\n");
+}
+
+/* ---------- lookup.h: minimized DFA ---------- */
+
+static const int dfa_result[] = { 0, 0, 1, 1, 2, 3 };   // lookupKeyword() value per class
+
+// Input bytes are mapped to a few classes (one per character that occurs
+// in some word, upper and lower case alike; 0 for everything else) so the
+// transition table stays small enough to sit in L1.
+static int nclasses = 1;
+static unsigned char byte_class[256];
+static char class_char[64];
+
+typedef struct {
+    int next[64];   // by byte class; 0 = dead state
+    int accept;     // lookupKeyword() value
+} DfaState;
+
+static DfaState trie[KW_MAX_STATES];   // trie[0] is dead, trie[1] the start
+static int ntrie = 2;
+static DfaState dfa[KW_MAX_STATES];
+static int ndfa;
+static int canon[KW_MAX_STATES];       // trie state -> dfa state
+
+static void build_classes(void) {
+    for (int w = 0; w < nwords; ++w)
+        if (dfa_result[words[w].cls])
+            for (int i = 0; i < words[w].len; ++i) {
+                unsigned char c = (unsigned char)words[w].word[i];
+                if (byte_class[c]) continue;
+                class_char[nclasses] = (char)c;
+                byte_class[c] = (unsigned char)nclasses;
+                if (islower(c)) byte_class[toupper(c)] = (unsigned char)nclasses;
+                nclasses++;
+            }
+}
+
+static int build_trie(void) {
+    for (int w = 0; w < nwords; ++w) {
+        if (dfa_result[words[w].cls] == 0) continue;
+        int st = 1;
+        for (int i = 0; i < words[w].len; ++i) {
+            int c = byte_class[(unsigned char)words[w].word[i]];
+            if (!trie[st].next[c]) {
+                if (ntrie == KW_MAX_STATES) return 0;
+                trie[st].next[c] = ntrie++;
+            }
+            st = trie[st].next[c];
+        }
+        trie[st].accept = dfa_result[words[w].cls];
+    }
+    return 1;
+}
+
+// The trie is acyclic, so merging states whose accept value and (already
+// merged) successors are equal, children first, gives the minimal DFA.
+static void minimize(int st) {
+    DfaState sig = { {0}, trie[st].accept };
+    for (int c = 1; c < nclasses; ++c) {
+        int nx = trie[st].next[c];
+        if (nx) { minimize(nx); sig.next[c] = canon[nx]; }
+    }
+    for (int d = 1; d < ndfa; ++d)
+        if (memcmp(&dfa[d], &sig, sizeof(sig)) == 0) { canon[st] = d; return; }
+    dfa[ndfa] = sig;
+    canon[st] = ndfa++;
+}
+
+// renumber breadth-first from the start state, so the start is 1 and the
+// states a lookup visits first sit together at the front of the table
+static int order[KW_MAX_STATES], renum[KW_MAX_STATES];
+
+static int number_states(int start) {
+    int n = 0, head = 0;
+    memset(renum, 0, sizeof(renum));
+    order[n++] = start;
+    renum[start] = 1;
+    while (head < n) {
+        int d = order[head++];
+        for (int c = 1; c < nclasses; ++c) {
+            int nx = dfa[d].next[c];
+            if (nx && !renum[nx]) { renum[nx] = n + 1; order[n++] = nx; }
+        }
+    }
+    return n;
+}
+
+static int dfa_run(int start, const char *s) {
+    int st = start;
+    for (; *s; ++s) {
+        st = dfa[st].next[byte_class[(unsigned char)*s]];
+        if (!st) return 0;
+    }
+    return dfa[st].accept;
+}
+
+static int spec_result(const char *s) {
+    for (int w = 0; w < nwords; ++w)
+        if (strcasecmp(words[w].word, s) == 0) return dfa_result[words[w].cls];
+    return 0;
+}
+
+static int check_dfa(int start) {
+    char buf[KW_MAX_LEN + 2];
+    for (int w = 0; w < nwords; ++w) {
+        for (int len = 0; len <= words[w].len; ++len) {
+            memcpy(buf, words[w].word, (size_t)len);
+            buf[len] = '\0';
+            int want = spec_result(buf);
+            if (dfa_run(start, buf) != want) { fprintf(stderr, "DFA is wrong on '%s'\n", buf); return 0; }
+            if (len < words[w].len) continue;
+            for (int c = 0; c < 256; ++c) {
+                if (c == 0) continue;
+                buf[len] = (char)c;
+                buf[len + 1] = '\0';
+                if (dfa_run(start, buf) != spec_result(buf)) {
+                    fprintf(stderr, "DFA is wrong on '%s'\n", buf);
+                    return 0;
+                }
+            }
+            buf[0] = (char)toupper((unsigned char)buf[0]);
+            buf[len] = '\0';
+            if (dfa_run(start, buf) != want) { fprintf(stderr, "DFA is wrong on '%s'\n", buf); return 0; }
+        }
+    }
+    return 1;
+}
+
+static void emit_dfa(const char *spec, int nstates) {
+    printf("// DFA keyword, reserved word, noise word matcher for SIMPLE language\n");
+    printf("// Returns: 0 = NOT A KEYWORD, 1 = KEYWORD, 2 = RESERVED, 3 = NOISE\n");
+    printf("//\n");
+    printf("// The lexer classifies words with wordclass.h; this header is kept only for\n");
+    printf("// the lookupKeyword() API, for code written against the old matcher.\n");
+    printf("//\n");
+    printf("// Generated by kwgen from %s - do not edit; change the word list and run:\n", spec);
+    printf("//     ./kwgen --dfa %s > lookup.h\n", spec);
+    printf("// Minimized DFA: %d states over %d input classes (%zu bytes of transitions).\n\n",
+           nstates, nclasses, (size_t)(nstates + 1) * (size_t)nclasses);
+    printf("#ifndef LOOKUP_H\n#define LOOKUP_H\n\n");
+
+    printf("// input class per byte (upper and lower case share one), 0 = in no word\n");
+    printf("static const unsigned char lk_class[256] = {");
+    for (int c = 0; c < 256; ++c) {
+        if (c % 16 == 0) printf("\n   ");
+        printf(" %2d,", byte_class[c]);
+    }
+    printf("\n};\n\n");
+
+    printf("// lk_next[state][class]; state 0 is dead, 1 is the start\n");
+    printf("static const unsigned char lk_next[%d][%d] = {\n", nstates + 1, nclasses);
+    printf("    /*        ");
+    for (int c = 0; c < nclasses; ++c) printf(" '%c',", c ? class_char[c] : '-');
+    printf(" */\n");
+    for (int r = 0; r <= nstates; ++r) {
+        printf("    /* %3d */ {", r);
+        for (int c = 0; c < nclasses; ++c)
+            printf(" %3d,", r ? renum[dfa[order[r - 1]].next[c]] : 0);
+        printf(" },\n");
+    }
+    printf("};\n\n");
+
+    printf("static const unsigned char lk_accept[%d] = {", nstates + 1);
+    for (int r = 0; r <= nstates; ++r) {
+        if (r % 16 == 0) printf("\n   ");
+        printf(" %d,", r ? dfa[order[r - 1]].accept : 0);
+    }
+    printf("\n};\n\n");
+
+    printf("static int lookupKeyword(const char *s) {\n");
+    printf("    unsigned st = 1;\n");
+    printf("    for (; *s; ++s) {\n");
+    printf("        st = lk_next[st][lk_class[(unsigned char)*s]];\n");
+    printf("        if (st == 0) return 0;\n");
+    printf("    }\n");
+    printf("    return lk_accept[st];\n");
+    printf("}\n\n");
+    printf("#endif // LOOKUP_H\n");
+}
+
+static int generate_dfa(const char *spec) {
+    build_classes();
+    if (nclasses > 64 || !build_trie()) { fprintf(stderr, "word list too large for the DFA\n"); return 1; }
+    ndfa = 1;                     // dfa[0] is the dead state
+    minimize(1);
+    int start = canon[1];
+    if (!check_dfa(start)) return 1;
+    int nstates = number_states(start);
+    if (nstates > 255) { fprintf(stderr, "too many DFA states for byte transitions\n"); return 1; }
+    emit_dfa(spec, nstates);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int dfa_mode = argc == 3 && strcmp(argv[1], "--dfa") == 0;
+    if (argc != 2 && !dfa_mode) {
+        fprintf(stderr, "usage: %s keywords.txt > wordclass.h\n", argv[0]);
+        fprintf(stderr, "       %s --dfa keywords.txt > lookup.h\n", argv[0]);
+        return 2;
+    }
+    const char *path = argv[argc - 1];
+    if (!read_spec(path)) return 1;
+    if (nwords == 0) { fprintf(stderr, "%s: no words\n", path); return 1; }
+    const char *spec = strrchr(path, '/');
+    spec = spec ? spec + 1 : path;
+    if (dfa_mode) return generate_dfa(spec);
+
+    unsigned k[4];
+    unsigned size = find_hash(k);
+    if (!size) { fprintf(stderr, "no perfect hash found for %d words\n", nwords); return 1; }
+
+    emit_header(spec, k, size);
+    return 0;
+}
@@ -0,0 +1,656 @@
+// Reentrant SIMPLE lexer.
+// All scanner state lives in a Lexer, so several lexers can run side by side
+// (one per thread or per file) and a parser can pull tokens one at a time:
+//
+//     Lexer lx;
+//     Token tok;
+//     if (!lexer_open(&lx, "prog.simp")) ...;      // or lexer_init() on a buffer
+//     while (lexer_next(&lx, &tok)) { ... }
+//     lexer_destroy(&lx);
+//
+// Tokens are spans into the source; lexer_lexeme() gives their printable text.
+// They carry no line or column: positions are byte offsets, resolved through
+// a line index (lineindex.h) only when they are printed.
+
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "numlit.h"  // INT/FLOAT/TIME/DATE/TIMESTAMP classification and values
+#include "simd.h"    // vectorized whitespace / identifier / number runs
+#include "source.h"  // mmap / read-once input buffer
+#include "stats.h"   // --stats counters; empty unless built with SIMPLE_STATS
+#include "wordclass.h" // generated by kwgen from keywords.txt
+
+#define MAX_LEX 4096
+
+/* Bumped whenever the token stream for some input changes (types, spans,
+   positions or flags), so caches of lexer output know to start over. */
+#define LEXER_VERSION 3
+
+typedef enum {
+    T_NEWLINE, T_WHITESPACE, T_COMMENT,
+    T_STRING, T_TEXT, T_SECURE, T_CHAR,
+    T_FLOAT, T_INT, T_BOOL, T_TIME, T_DATE, T_TIMESTAMP,
+    T_ARRAY, T_COLLECTION,
+    T_DATATYPE, T_KEYWORD, T_RESERVED, T_NOISE, T_IDENTIFIER,
+    T_UNARY_OP, T_EXP_OP, T_ASSIGN_OP, T_REL_OP, T_LOGICAL_OP, T_ARITH_OP,
+    T_COLON, T_COMMA, T_LPAREN, T_RPAREN, T_LBRACKET, T_RBRACKET,
+    T_LEX_ERROR, T_UNKNOWN,
+    T_COUNT
+} SymType;
+
+/* mapping from SymType to name used in symbol table & summary */
+static const char *token_names[T_COUNT] = {
+    "NEWLINE", "WHITESPACE", "COMMENT",
+    "STRING", "TEXT", "SECURE", "CHAR",
+    "FLOAT", "INT", "BOOL", "TIME", "DATE", "TIMESTAMP",
+    "ARRAY", "COLLECTION",
+    "DATATYPE", "KEYWORD", "RESERVED", "NOISE", "IDENTIFIER",
+    "UNARY_OP", "EXP_OP", "ASSIGN_OP", "REL_OP", "LOGICAL_OP", "ARITH_OP",
+    "COLON", "COMMA", "LPAREN", "RPAREN", "LBRACKET", "RBRACKET",
+    "LEXICAL_ERROR", "UNKNOWN"
+};
+
+/* Lexemes are not copied: a token records the (offset, length) span of its
+   lexeme inside the source buffer and the text is produced when printed.
+   SYMF_COOKED marks the few lexemes that differ from their raw span. */
+#define SYMF_COOKED 0x01   /* TEXT with doubled quotes, "to do" with extra blanks */
+#define SYMF_SIGN   0x02   /* + or - typed UNARY_OP/ARITH_OP from the previous token */
+#define SYMF_VALUE  0x10   /* numeric/temporal literal whose value was parsed (see numlit.h) */
+#define SYMF_OPEN_SHIFT 2
+#define SYMF_OPEN_MASK  0x0c   /* bytes of opening delimiter before the lexeme: 3 for """, 1 for " ' ` { [ */
+#define SYMF_OPEN(n) ((unsigned)(n) << SYMF_OPEN_SHIFT)
+
+/* offset a token's position refers to: its opening delimiter, if it has one */
+static inline size_t lexer_token_start(size_t off, unsigned flags) {
+    return off - ((flags & SYMF_OPEN_MASK) >> SYMF_OPEN_SHIFT);
+}
+
+typedef struct {
+    SymType type;
+    unsigned flags;     /* SYMF_* */
+    size_t off;         /* lexeme start in the source */
+    size_t len;         /* lexeme length in bytes */
+    LitValue value;     /* if flags & SYMF_VALUE */
+} Token;
+
+/* one construct can produce up to three tokens ('[' ARRAY ']') */
+#define LEX_QUEUE 4
+
+typedef struct {
+    SourceBuf src;          /* cursor over the whole input */
+    size_t limit;           /* no new token is started at or after this offset */
+    bool owns_src;          /* lexer_open() mapped it, lexer_destroy() unmaps it */
+
+    /* (for unary detection) */
+    SymType prev_type;      /* start-of-input acts like newline -> allows unary at start */
+    bool prev_lexeme_empty;
+
+    Token queue[LEX_QUEUE]; /* tokens scanned but not yet returned */
+    int qhead, qtail;
+
+    char *scratch;          /* lexer_lexeme() buffer for cooked lexemes */
+    size_t scratch_cap;
+} Lexer;
+
+/* lex an in-memory buffer; the lexer borrows data, which must outlive it */
+static void lexer_init(Lexer *lx, const char *data, size_t len) {
+    memset(lx, 0, sizeof(*lx));
+    lx->src.data = data;
+    lx->src.len = len;
+    lx->limit = len;
+    lx->prev_type = T_NEWLINE;
+    lx->prev_lexeme_empty = true;
+}
+
+/* lex a file ("-" = stdin); returns 0 if it cannot be read (errno set) */
+static int lexer_open(Lexer *lx, const char *path) {
+    SourceBuf s;
+    if (!src_open(&s, path)) return 0;
+    lexer_init(lx, s.data, s.len);
+    lx->src = s;
+    lx->owns_src = true;
+    return 1;
+}
+
+/* Restrict the lexer to tokens starting in [begin, end). begin must be the
+   start of a line. The last token may run past end (a comment or literal
+   spanning lines), and the lexer state before begin is assumed to be
+   start-of-input. */
+static void lexer_set_range(Lexer *lx, size_t begin, size_t end) {
+    lx->src.pos = begin;
+    lx->limit = end < lx->src.len ? end : lx->src.len;
+    lx->prev_type = T_NEWLINE;
+    lx->prev_lexeme_empty = true;
+    lx->qhead = lx->qtail = 0;
+}
+
+static void lexer_destroy(Lexer *lx) {
+    if (lx->owns_src) src_close(&lx->src);
+    free(lx->scratch);
+    memset(lx, 0, sizeof(*lx));
+}
+
+/* Materialize a lexeme. Plain spans point straight into the source; cooked
+   ones are rebuilt into the lexer's scratch buffer, valid until the next call. */
+static const char *lexer_lexeme(Lexer *lx, size_t off, size_t len, SymType type, unsigned flags, size_t *out_len) {
+    const char *p = lx->src.data + off;
+
+    if (type == T_NEWLINE) { *out_len = 2; return "\\n"; }
+    if (!(flags & SYMF_COOKED)) { *out_len = len; return p; }
+
+    if (type == T_KEYWORD) { *out_len = 5; return "to do"; }
+
+    if (len + 1 > lx->scratch_cap) {
+        size_t cap = lx->scratch_cap ? lx->scratch_cap : 256;
+        while (cap < len + 1) cap *= 2;
+        char *nb = realloc(lx->scratch, cap);
+        if (!nb) { *out_len = len; return p; }
+        lx->scratch = nb;
+        lx->scratch_cap = cap;
+    }
+    /* TEXT: a doubled quote inside the literal stands for one quote */
+    size_t n = 0;
+    for (size_t i = 0; i < len; ++i) {
+        if (p[i] == '"' && i + 1 < len && p[i + 1] == '"') continue;
+        lx->scratch[n++] = p[i];
+    }
+    *out_len = n;
+    return lx->scratch;
+}
+
+static void lex_emit_flags(Lexer *lx, size_t off, size_t len, SymType type, unsigned flags) {
+    Token *t = &lx->queue[lx->qtail++];
+    t->type = type;
+    t->flags = flags;
+    t->off = off;
+    t->len = len;
+
+    /* Update prev token only for meaningful tokens — don't let whitespace/newline/comment overwrite context */
+    if (type != T_WHITESPACE && type != T_NEWLINE && type != T_COMMENT) {
+        lx->prev_type = type;
+        /* a lexeme starting with NUL printed as empty, and counts as empty here too */
+        lx->prev_lexeme_empty = (len == 0 || lx->src.data[off] == '\0');
+    }
+}
+
+static void lex_emit(Lexer *lx, size_t off, size_t len, SymType type) {
+    lex_emit_flags(lx, off, len, type, 0);
+}
+
+static void lex_emit_value(Lexer *lx, size_t off, size_t len, SymType type, LitValue v) {
+    lex_emit_flags(lx, off, len, type, SYMF_VALUE);
+    lx->queue[lx->qtail - 1].value = v;
+}
+
+static int lex_getch(Lexer *lx) {
+    if (lx->src.pos >= lx->src.len) return EOF;
+    return (unsigned char)lx->src.data[lx->src.pos++];
+}
+
+/* step the cursor back over the byte just read */
+static void lex_ungetch(Lexer *lx, int c) {
+    if (c == EOF || lx->src.pos == 0) return;
+    lx->src.pos--;
+}
+
+/* the unread bytes, as bounds for the simd_span_*() scanners */
+static const char *lex_cursor(const Lexer *lx) { return lx->src.data + lx->src.pos; }
+static const char *lex_end(const Lexer *lx) { return lx->src.data + lx->src.len; }
+
+/* consume everything up to stop */
+static void lex_skip_to(Lexer *lx, const char *stop) {
+    lx->src.pos = (size_t)(stop - lx->src.data);
+}
+
+static int lex_peekch(const Lexer *lx) {
+    return src_peek(&lx->src, 0);
+}
+
+/* look n bytes past the cursor without consuming anything */
+static int lex_peekch_at(const Lexer *lx, size_t n) {
+    return src_peek(&lx->src, n);
+}
+
+/* Helper: decide whether previous token context allows a unary + or - */
+static bool allows_unary_after(SymType prev_type, bool prev_lexeme_empty) {
+    switch (prev_type) {
+        case T_NEWLINE:
+        case T_ASSIGN_OP:
+        case T_ARITH_OP:
+        case T_REL_OP:
+        case T_LOGICAL_OP:
+        case T_UNARY_OP:
+        case T_COLON:
+        case T_COMMA:
+        case T_LPAREN:
+        case T_LBRACKET:
+            return true;
+        default:
+            break;
+    }
+    if (prev_lexeme_empty) return true;
+    return false;
+}
+
+static bool prev_allows_unary(const Lexer *lx) {
+    return allows_unary_after(lx->prev_type, lx->prev_lexeme_empty);
+}
+
+/* Byte classes for the first character of a construct: lex_scan() does one
+   table lookup and a switch instead of a chain of comparisons. Bytes >= 0x80
+   are all CC_OTHER. */
+typedef enum {
+    CC_OTHER, CC_NEWLINE, CC_BLANK, CC_SLASH, CC_DQUOTE, CC_BACKTICK, CC_SQUOTE,
+    CC_LBRACKET, CC_LBRACE, CC_DIGIT, CC_WORD, CC_OPERATOR
+} CharClass;
+
+#define XX CC_OTHER
+#define NL CC_NEWLINE
+#define BL CC_BLANK
+#define SL CC_SLASH
+#define DQ CC_DQUOTE
+#define BT CC_BACKTICK
+#define SQ CC_SQUOTE
+#define LB CC_LBRACKET
+#define LC CC_LBRACE
+#define DG CC_DIGIT
+#define WD CC_WORD
+#define OP CC_OPERATOR
+static const unsigned char lex_char_class[256] = {
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, BL, NL, XX, XX, XX, XX, XX,   /* 00-0f */
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,   /* 10-1f */
+    BL, OP, DQ, XX, XX, OP, OP, SQ, OP, OP, OP, OP, OP, OP, XX, SL,   /* 20-2f */
+    DG, DG, DG, DG, DG, DG, DG, DG, DG, DG, OP, XX, OP, OP, OP, XX,   /* 30-3f */
+    XX, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD,   /* 40-4f */
+    WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, LB, XX, OP, OP, WD,   /* 50-5f */
+    BT, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD,   /* 60-6f */
+    WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, WD, LC, OP, XX, OP, XX,   /* 70-7f */
+    /* 0x80-0xff: CC_OTHER */
+};
+#undef XX
+#undef NL
+#undef BL
+#undef SL
+#undef DQ
+#undef BT
+#undef SQ
+#undef LB
+#undef LC
+#undef DG
+#undef WD
+#undef OP
+
+/* COMMENTS and special handling for '/=' etc */
+static void lex_scan_slash(Lexer *lx, size_t start_pos) {
+    int nxt = lex_getch(lx);
+    if (nxt == '/') {
+        const char *nl = memchr(lex_cursor(lx), '\n', lx->src.len - lx->src.pos);
+        lex_skip_to(lx, nl ? nl : lex_end(lx));
+        lex_emit(lx, start_pos, lx->src.pos - start_pos, T_COMMENT);
+        if (nl) lex_getch(lx);   /* the comment owns its line break */
+        return;
+    }
+    else if (nxt == '*') {
+        // the opener's own '*' does not count, so "/*/" is still open
+        const char *p = lex_cursor(lx), *end = lex_end(lx), *star, *stop = end;
+        int closed = 0;
+        while ((star = memchr(p, '*', (size_t)(end - p))) != NULL && star + 1 < end) {
+            if (star[1] == '/') { closed = 1; stop = star + 2; break; }
+            p = star + 1;
+        }
+        lex_skip_to(lx, stop);
+        size_t len = lx->src.pos - start_pos;
+        if (!closed) lex_emit(lx, start_pos, len, T_LEX_ERROR);
+        else lex_emit(lx, start_pos, len, T_COMMENT);
+        return;
+    }
+    else if (nxt == '=') {
+        /* handle "/=" assignment */
+        lex_emit(lx, start_pos, 2, T_ASSIGN_OP);
+        return;
+    }
+    else {
+        if (nxt != EOF) lex_ungetch(lx, nxt);
+        lex_emit(lx, start_pos, 1, T_ARITH_OP);
+        return;
+    }
+}
+
+/* TRIPLE-QUOTED TEXT (""" ... """) or STRING LITERAL "..." */
+static void lex_scan_quote(Lexer *lx) {
+    int p1 = lex_peekch_at(lx, 0);
+    int p2 = lex_peekch_at(lx, 1);
+    if (p1 == '"' && p2 == '"') {
+        // consume two extra quotes
+        lex_getch(lx); lex_getch(lx); // now we've consumed three quotes total (first c and the two)
+        // read until triple quote
+        size_t body = lx->src.pos;
+        size_t body_end = lx->src.len;
+        unsigned flags = 0;
+        int closed = 0;
+        const char *p = lex_cursor(lx), *end = lex_end(lx), *q, *stop = end;
+        while ((q = memchr(p, '"', (size_t)(end - p))) != NULL) {
+            if (q + 1 < end && q[1] == '"') {
+                if (q + 2 < end && q[2] == '"') {
+                    body_end = (size_t)(q - lx->src.data);
+                    stop = q + 3;
+                    closed = 1;
+                    break;
+                }
+                // uncommon case: only two quotes, the literal keeps one of them
+                flags = SYMF_COOKED;
+            }
+            p = q + 1;
+        }
+        lex_skip_to(lx, stop);
+        flags |= SYMF_OPEN(3);
+        if (!closed) lex_emit_flags(lx, body, body_end - body, T_LEX_ERROR, flags);
+        else lex_emit_flags(lx, body, body_end - body, T_TEXT, flags);
+        return;
+    }
+
+    /* STRING LITERAL "..." (single-line preferred) */
+    size_t body = lx->src.pos;
+    size_t body_end = lx->src.len;
+    int closed = 0;
+    const char *p = lex_cursor(lx), *end = lex_end(lx);
+    while ((p = simd_find2(p, end, '"', '\\')) < end) {
+        if (*p == '\\') {
+            // escaped char is kept as-is (we store inner content)
+            if (p + 1 == end) { body_end = (size_t)(p - lx->src.data); p = end; break; }
+            p += 2;
+            continue;
+        }
+        closed = 1;
+        body_end = (size_t)(p - lx->src.data);
+        p++;
+        break;
+    }
+    lex_skip_to(lx, p);
+    if (!closed) lex_emit_flags(lx, body, body_end - body, T_LEX_ERROR, SYMF_OPEN(1));
+    else lex_emit_flags(lx, body, body_end - body, T_STRING, SYMF_OPEN(1));
+}
+
+/* SECURE literal: backtick-delimited with NO SPACES inside */
+static void lex_scan_secure(Lexer *lx) {
+    size_t body = lx->src.pos;
+    size_t body_end = lx->src.len;
+    int closed = 0;
+    bool has_space = false;
+    const char *q = memchr(lex_cursor(lx), '`', lx->src.len - lx->src.pos);
+    if (q) { closed = 1; body_end = (size_t)(q - lx->src.data); }
+    for (size_t i = body; i < body_end && !has_space; ++i)
+        if (isspace((unsigned char)lx->src.data[i])) has_space = true;
+    lex_skip_to(lx, q ? q + 1 : lex_end(lx));
+    if (!closed || has_space) lex_emit_flags(lx, body, body_end - body, T_LEX_ERROR, SYMF_OPEN(1));
+    else lex_emit_flags(lx, body, body_end - body, T_SECURE, SYMF_OPEN(1));
+}
+
+/* CHAR literal: 'A' (we will return lexeme as A without quotes) */
+static void lex_scan_char(Lexer *lx) {
+    size_t body = lx->src.pos;
+    int ch = lex_getch(lx);
+    if (ch == EOF) { lex_emit_flags(lx, body, 0, T_LEX_ERROR, SYMF_OPEN(1)); return; }
+    if (ch == '\\') {
+        int esc = lex_getch(lx);
+        if (esc == EOF) { lex_emit_flags(lx, body, 0, T_LEX_ERROR, SYMF_OPEN(1)); return; }
+        // accept escaped single char like '\n', '\'', '\\'
+        ch = lex_getch(lx); // should be closing ''
+        if (ch != '\'') { lex_emit_flags(lx, body, 0, T_LEX_ERROR, SYMF_OPEN(1)); return; }
+        lex_emit_flags(lx, body, 2, T_CHAR, SYMF_OPEN(1));
+        return;
+    } else {
+        // single character then expect closing '\''
+        int closing = lex_getch(lx);
+        if (closing != '\'') {
+            lex_emit_flags(lx, body, 0, T_LEX_ERROR, SYMF_OPEN(1));
+            return;
+        } else {
+            lex_emit_flags(lx, body, 1, T_CHAR, SYMF_OPEN(1));
+            return;
+        }
+    }
+}
+
+/* BRACKET / ARRAY handling: decide whether ARRAY literal or LBRACKET delimiter */
+static void lex_scan_bracket(Lexer *lx, size_t start_pos) {
+    /* Peek ahead skipping spaces/tabs to inspect next non-space character */
+    size_t ahead = 0;
+    int next_non_ws;
+    while ((next_non_ws = lex_peekch_at(lx, ahead)) == ' ' || next_non_ws == '\t') ahead++;
+
+    /* Heuristic: treat as ARRAY literal when next non-space char is one typical of literals
+       or if it's a closing ']' (empty array) */
+    if (next_non_ws == ']' || isdigit(next_non_ws) || next_non_ws == '"' || next_non_ws == '\'' ||
+        next_non_ws == '`' || next_non_ws == '{' || next_non_ws == '[' || next_non_ws == '-' ) {
+
+        /* Emit LBRACKET token first so brackets are visible in symbol table */
+        lex_emit(lx, start_pos, 1, T_LBRACKET);
+
+        size_t body = lx->src.pos;
+        int depth = 1;
+        int ch;
+        bool closed = false;
+        while ((ch = lex_getch(lx)) != EOF) {
+            if (ch == '[') depth++;
+            else if (ch == ']') {
+                depth--;
+                if (depth == 0) { closed = true; break; }
+            }
+        }
+        if (!closed) {
+            lex_emit_flags(lx, body, lx->src.pos - body, T_LEX_ERROR, SYMF_OPEN(1));
+        } else {
+            /* add ARRAY inner content as a token (for analysis) */
+            lex_emit(lx, body, lx->src.pos - 1 - body, T_ARRAY);
+            /* Emit RBRACKET token at current position */
+            lex_emit(lx, lx->src.pos - 1, 1, T_RBRACKET);
+        }
+        return;
+    } else {
+        /* Treat it as simple LBRACKET delimiter */
+        lex_emit(lx, start_pos, 1, T_LBRACKET);
+        return;
+    }
+}
+
+/* COLLECTIONS: { ... } => COLLECTION (inner content as lexeme) */
+static void lex_scan_collection(Lexer *lx) {
+    size_t body = lx->src.pos;
+    int depth = 1;
+    int ch;
+    bool closed = false;
+    while ((ch = lex_getch(lx)) != EOF) {
+        if (ch == '{') depth++;
+        else if (ch == '}') { depth--; if (depth == 0) { closed = true; break; } }
+    }
+    if (!closed) lex_emit_flags(lx, body, lx->src.pos - body, T_LEX_ERROR, SYMF_OPEN(1));
+    else lex_emit_flags(lx, body, lx->src.pos - 1 - body, T_COLLECTION, SYMF_OPEN(1));
+}
+
+/* If starts with digit => could be INT, FLOAT, TIME, DATE, TIMESTAMP.
+   One pass over the literal classifies it and parses its value. */
+static void lex_scan_number(Lexer *lx, size_t start_pos) {
+    static const SymType types[] = {
+        [NL_INT] = T_INT, [NL_FLOAT] = T_FLOAT, [NL_TIME] = T_TIME, [NL_DATE] = T_DATE,
+        [NL_TIMESTAMP] = T_TIMESTAMP, [NL_DATE_SPLIT] = T_DATE, [NL_ERROR] = T_LEX_ERROR,
+    };
+    const char *text = lx->src.data + start_pos;
+    NumScan ns;
+    lex_skip_to(lx, numlit_scan(&ns, text, lex_end(lx), MAX_LEX - 1));
+    NumClass nc = numlit_classify(&ns);
+
+    size_t len = ns.len;
+    if (nc == NL_DATE_SPLIT) {
+        /* a date, then something that is not a time: rewind so the part after the space is scanned again */
+        len = ns.space;
+        lx->src.pos = start_pos + ns.space + 1;
+    }
+    LitValue v;
+    if (numlit_value(&ns, nc, text, &v)) lex_emit_value(lx, start_pos, len, types[nc], v);
+    else lex_emit(lx, start_pos, len, types[nc]);
+}
+
+/* IDENTIFIER / KEYWORD / DATATYPE / RESERVED / NOISE + SPECIAL CASE: "to do" */
+static void lex_scan_word(Lexer *lx, size_t start_pos) {
+    lex_skip_to(lx, simd_span_ident(lex_cursor(lx), lex_end(lx)));
+    size_t len = lx->src.pos - start_pos;
+    const char *word = lx->src.data + start_pos;
+
+    /* SPECIAL MERGE RULE FOR "to do" */
+    if (len == 2 && word[0] == 't' && word[1] == 'o') {
+        size_t ws_count = 0;
+        int ww;
+        while ((ww = lex_peekch_at(lx, ws_count)) == ' ' || ww == '\t') ws_count++;
+        if (ws_count > 0 && lex_peekch_at(lx, ws_count) == 'd' && lex_peekch_at(lx, ws_count + 1) == 'o' &&
+            !isalpha(lex_peekch_at(lx, ws_count + 2))) {
+            for (size_t k = 0; k < ws_count + 2; k++) lex_getch(lx);
+            /* the lexeme is always printed as "to do", however the blanks were written */
+            lex_emit_flags(lx, start_pos, lx->src.pos - start_pos, T_KEYWORD,
+                           ws_count == 1 && word[2] == ' ' ? 0 : SYMF_COOKED);
+            return;
+        }
+    }
+
+    /* one probe for BOOL / DATATYPE / KEYWORD / RESERVED / NOISE, case-insensitive */
+    static const SymType word_types[] = {
+        [WC_IDENT] = T_IDENTIFIER, [WC_BOOL] = T_BOOL, [WC_DATATYPE] = T_DATATYPE,
+        [WC_KEYWORD] = T_KEYWORD, [WC_RESERVED] = T_RESERVED, [WC_NOISE] = T_NOISE,
+    };
+    STATS_START(t_word);
+    WordClass wc = classify_word(word, len);
+    STATS_PHASE(PHASE_WORDS, t_word);
+    lex_emit(lx, start_pos, len, word_types[wc]);
+}
+
+/* Operator table, two levels: lex_ops[c] is the row for the first byte and
+   two[lex_op_second[next byte]] the two-char operator it starts, if any.
+   0 (T_NEWLINE) never names an operator, so it marks "none" in two[]. */
+enum { OP2_NONE, OP2_EQ, OP2_PLUS, OP2_MINUS, OP2_AMP, OP2_BAR, OP2_COUNT };
+
+static const unsigned char lex_op_second[256] = {
+    ['='] = OP2_EQ, ['+'] = OP2_PLUS, ['-'] = OP2_MINUS, ['&'] = OP2_AMP, ['|'] = OP2_BAR,
+};
+
+typedef struct {
+    unsigned char one;              /* SymType of the byte on its own */
+    unsigned char sign;             /* + or -: unary or binary depends on the previous token */
+    unsigned char two[OP2_COUNT];   /* SymType of the two-char operator, 0 = none */
+} LexOpRow;
+
+/* indexed by CC_OPERATOR bytes, which are all ASCII ('/' is lex_scan_slash's) */
+static const LexOpRow lex_ops[128] = {
+    ['+'] = { T_ARITH_OP,   1, { [OP2_PLUS] = T_UNARY_OP, [OP2_EQ] = T_ASSIGN_OP } },
+    ['-'] = { T_ARITH_OP,   1, { [OP2_MINUS] = T_UNARY_OP, [OP2_EQ] = T_ASSIGN_OP } },
+    ['*'] = { T_ARITH_OP,   0, { [OP2_EQ] = T_ASSIGN_OP } },
+    ['%'] = { T_ARITH_OP,   0, { [OP2_EQ] = T_ASSIGN_OP } },
+    ['~'] = { T_ARITH_OP,   0, { [OP2_EQ] = T_ASSIGN_OP } },
+    ['^'] = { T_EXP_OP,     0, { 0 } },
+    ['='] = { T_ASSIGN_OP,  0, { [OP2_EQ] = T_REL_OP } },
+    ['<'] = { T_REL_OP,     0, { [OP2_EQ] = T_REL_OP } },
+    ['>'] = { T_REL_OP,     0, { [OP2_EQ] = T_REL_OP } },
+    ['!'] = { T_LOGICAL_OP, 0, { [OP2_EQ] = T_REL_OP } },
+    ['&'] = { T_LEX_ERROR,  0, { [OP2_AMP] = T_LOGICAL_OP } },
+    ['|'] = { T_LEX_ERROR,  0, { [OP2_BAR] = T_LOGICAL_OP } },
+    [':'] = { T_COLON,      0, { 0 } },
+    [','] = { T_COMMA,      0, { 0 } },
+    ['('] = { T_LPAREN,     0, { 0 } },
+    [')'] = { T_RPAREN,     0, { 0 } },
+    [']'] = { T_RBRACKET,   0, { 0 } },
+};
+
+/* Operator starting with c when nxt (or EOF) follows: its type and length.
+   A lone + or - comes back as T_ARITH_OP with *sign set for the caller to
+   decide unary vs binary. */
+static SymType lex_match_operator(int c, int nxt, size_t *len, bool *sign) {
+    const LexOpRow *op = &lex_ops[c & 0x7f];
+    unsigned two = nxt == EOF ? 0 : op->two[lex_op_second[(unsigned char)nxt]];
+    if (two) {
+        *len = 2;
+        *sign = false;
+        return (SymType)two;
+    }
+    *len = 1;
+    *sign = op->sign;
+    return (SymType)op->one;
+}
+
+/* OPERATORS and DELIMITERS: everything left over, c is the byte at start_pos */
+static void lex_scan_operator(Lexer *lx, int c, size_t start_pos) {
+    size_t len;
+    bool sign;
+    SymType type = lex_match_operator(c, lex_peekch(lx), &len, &sign);
+
+    if (len == 2) {
+        lex_getch(lx);   /* the second byte; c was the first */
+        lex_emit(lx, start_pos, 2, type);
+    } else if (sign) {
+        /* PLUS and MINUS: decide unary vs binary */
+        lex_emit_flags(lx, start_pos, 1, prev_allows_unary(lx) ? T_UNARY_OP : T_ARITH_OP, SYMF_SIGN);
+    } else {
+        lex_emit(lx, start_pos, 1, type);
+    }
+}
+
+/* Scan one construct starting at the cursor, queueing the token(s) it produces. */
+static void lex_scan(Lexer *lx) {
+    int c = lex_getch(lx);
+    if (c == EOF) return;
+
+    size_t start_pos = lx->src.pos - 1;   /* offset of c */
+
+    switch ((CharClass)lex_char_class[c]) {
+    case CC_NEWLINE:
+        lex_emit(lx, start_pos, 1, T_NEWLINE);
+        return;
+
+    case CC_BLANK:
+        lex_skip_to(lx, simd_span_ws(lex_cursor(lx), lex_end(lx)));
+        lex_emit(lx, start_pos, lx->src.pos - start_pos, T_WHITESPACE);
+        return;
+
+    case CC_SLASH:     lex_scan_slash(lx, start_pos); return;
+    case CC_DQUOTE:    lex_scan_quote(lx); return;
+    case CC_BACKTICK:  lex_scan_secure(lx); return;
+    case CC_SQUOTE:    lex_scan_char(lx); return;
+    case CC_LBRACKET:  lex_scan_bracket(lx, start_pos); return;
+    case CC_LBRACE:    lex_scan_collection(lx); return;
+    case CC_DIGIT: {
+        STATS_START(t_num);
+        lex_scan_number(lx, start_pos);
+        STATS_PHASE(PHASE_NUMBERS, t_num);
+        return;
+    }
+    case CC_WORD:      lex_scan_word(lx, start_pos); return;
+    case CC_OPERATOR:  lex_scan_operator(lx, c, start_pos); return;
+
+    case CC_OTHER:
+        break;
+    }
+
+    /* UNKNOWN CHARACTER -> lexical error */
+    lex_emit(lx, start_pos, 1, T_LEX_ERROR);
+}
+
+/* Pull the next token; returns 1 and fills *tok, or 0 at end of input. */
+static int lexer_next(Lexer *lx, Token *tok) {
+    while (lx->qhead == lx->qtail) {
+        if (lx->src.pos >= lx->limit) return 0;
+        lx->qhead = lx->qtail = 0;
+        STATS_SCAN_START(t_scan);
+        lex_scan(lx);
+        STATS_SCAN(t_scan, lx->queue, lx->qtail);
+    }
+    *tok = lx->queue[lx->qhead++];
+    return 1;
+}
+
+#endif // LEXER_H
@@ -0,0 +1,119 @@
+// Line index: where every line of a source buffer starts.
+// Tokens carry only byte offsets; line and column are worked out from this
+// index when a position is actually printed. The index is built in one pass
+// that tests 16 bytes at a time for '\n' (SSE2, see simd.h), and a lookup is
+// a binary search, or O(1) when lookups walk forward through the file the
+// way the table writers do.
+//
+//     LineIndex li;
+//     if (!li_build(&li, data, len)) ...;       // out of memory
+//     li_position(&li, off, &line, &col);       // both 1-based, in bytes
+//     li_free(&li);
+//
+// LineCursor is the forward-only variant for --stream, which never holds a
+// table: it counts the newlines between one printed offset and the next,
+// in constant memory.
+
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simd.h"
+
+typedef struct {
+    uint32_t *start;   // start[i] = offset of line i + 1, so start[0] = 0
+    size_t count;      // lines
+    size_t cap;
+    size_t hint;       // line (0-based) of the last lookup
+} LineIndex;
+
+static void li_free(LineIndex *li) {
+    free(li->start);
+    memset(li, 0, sizeof(*li));
+}
+
+static inline int li_push(LineIndex *li, size_t off) {
+    if (li->count == li->cap) {
+        size_t ncap = li->cap * 2;
+        uint32_t *ns = realloc(li->start, ncap * sizeof(*ns));
+        if (!ns) return 0;
+        li->start = ns;
+        li->cap = ncap;
+    }
+    li->start[li->count++] = (uint32_t)off;
+    return 1;
+}
+
+// index data[0, len) (at most 4 GB, like the token table); returns 0 when out of memory
+static int li_build(LineIndex *li, const char *data, size_t len) {
+    memset(li, 0, sizeof(*li));
+    li->cap = len / 32 + 16;   // lines average a few dozen bytes
+    li->start = malloc(li->cap * sizeof(*li->start));
+    if (!li->start) return 0;
+    li->start[li->count++] = 0;
+
+    size_t i = 0;
+#ifdef SIMD_SSE2
+    const __m128i nl = _mm_set1_epi8('\n');
+    for (; len - i >= 16; i += 16) {
+        unsigned hit = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i)), nl));
+        for (; hit; hit &= hit - 1)
+            if (!li_push(li, i + simd_ctz(hit) + 1)) return 0;
+    }
+#endif
+    for (; i < len; ++i)
+        if (data[i] == '\n' && !li_push(li, i + 1)) return 0;
+    return 1;
+}
+
+// line and column of byte off; a '\n' belongs to the line it ends
+static void li_position(LineIndex *li, size_t off, unsigned *line, unsigned *col) {
+    size_t l = li->hint;
+    if (li->start[l] > off || (l + 1 < li->count && li->start[l + 1] <= off)) {
+        if (li->start[l] <= off && (l + 2 >= li->count || li->start[l + 2] > off)) {
+            l++;   // the next line: the common case for writers walking the table
+        } else {
+            size_t lo = 0, hi = li->count;   // last line starting at or before off
+            while (hi - lo > 1) {
+                size_t mid = (lo + hi) / 2;
+                if (li->start[mid] <= off) lo = mid;
+                else hi = mid;
+            }
+            l = lo;
+        }
+        li->hint = l;
+    }
+    *line = (unsigned)(l + 1);
+    *col = (unsigned)(off - li->start[l] + 1);
+}
+
+typedef struct {
+    const char *data;
+    size_t pos;          // newlines before pos are counted
+    size_t line_start;   // offset of the line holding pos
+    unsigned long line;
+} LineCursor;
+
+static inline void lc_init(LineCursor *lc, const char *data) {
+    lc->data = data;
+    lc->pos = lc->line_start = 0;
+    lc->line = 1;
+}
+
+// line and column of byte off, which must not be before the previous call's
+static inline void lc_position(LineCursor *lc, size_t off, unsigned long *line, unsigned long *col) {
+    const char *p = lc->data + lc->pos, *e = lc->data + off, *nl;
+    while (p < e && (nl = memchr(p, '\n', (size_t)(e - p))) != NULL) {
+        lc->line++;
+        lc->line_start = (size_t)(nl - lc->data) + 1;
+        p = nl + 1;
+    }
+    if (off > lc->pos) lc->pos = off;
+    *line = lc->line;
+    *col = off - lc->line_start + 1;
+}
+
+#endif // LINEINDEX_H
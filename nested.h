@@ -0,0 +1,132 @@
+// Element tokens of ARRAY and COLLECTION literals.
+// The lexer records an array or a collection as one token, the span of its
+// body between the brackets or braces, after nothing more than a bracket
+// count. nested_elements() lexes a body the first time someone asks for it,
+// with a lexer confined to that span. That is the same scanner, so a nested
+// array comes back as an ARRAY token whose own elements can be asked for in
+// turn. The result is kept, so a large data literal costs nothing until it
+// is inspected, and each body is lexed at most once.
+//
+//     NestedCache nc;
+//     nested_init(&nc, src, src_len);
+//     const SymTable *el = nested_elements(&nc, type, off, len);   // token (type, off, len)
+//     if (el) ... el->type[k], el->off[k] ...   // offsets into src, like the parent's
+//     nested_free(&nc);
+//
+// Bodies are keyed by their offset, which no two array or collection tokens
+// share, so one cache serves every table over src: the top-level one, a
+// folded one, and the element tables themselves.
+
+#ifndef NESTED_H
+#define NESTED_H
+
+#include "lexer.h"
+#include "symtab.h"
+
+typedef struct {
+    const char *src;
+    size_t src_len;
+    uint32_t *key;      // body offset ...
+    SymTable **tab;     // ... and its elements; NULL marks a free slot
+    size_t cap;         // slots, a power of two
+    size_t count;
+} NestedCache;
+
+static void nested_init(NestedCache *nc, const char *src, size_t src_len) {
+    memset(nc, 0, sizeof(*nc));
+    nc->src = src;
+    nc->src_len = src_len;
+}
+
+// forget every element table (they are freed), keeping the slots
+static void nested_clear(NestedCache *nc) {
+    for (size_t i = 0; i < nc->cap; ++i)
+        if (nc->tab[i]) {
+            symtab_free(nc->tab[i]);
+            free(nc->tab[i]);
+            nc->tab[i] = NULL;
+        }
+    nc->count = 0;
+}
+
+static void nested_free(NestedCache *nc) {
+    nested_clear(nc);
+    free(nc->key);
+    free(nc->tab);
+    memset(nc, 0, sizeof(*nc));
+}
+
+static inline size_t nested_slot(const NestedCache *nc, uint32_t off) {
+    uint32_t h = off * 0x9E3779B1u;
+    size_t i = (size_t)((h ^ h >> 16) & (nc->cap - 1));
+    while (nc->tab[i] && nc->key[i] != off) i = (i + 1) & (nc->cap - 1);
+    return i;
+}
+
+// double the slots (or make the first 64); returns 0 when out of memory
+static int nested_grow(NestedCache *nc) {
+    NestedCache old = *nc;
+    nc->cap = old.cap ? old.cap * 2 : 64;
+    nc->key = malloc(nc->cap * sizeof(*nc->key));
+    nc->tab = calloc(nc->cap, sizeof(*nc->tab));
+    if (!nc->key || !nc->tab) {
+        free(nc->key);
+        free(nc->tab);
+        *nc = old;
+        return 0;
+    }
+    for (size_t i = 0; i < old.cap; ++i)
+        if (old.tab[i]) {
+            size_t s = nested_slot(nc, old.key[i]);
+            nc->key[s] = old.key[i];
+            nc->tab[s] = old.tab[i];
+        }
+    free(old.key);
+    free(old.tab);
+    return 1;
+}
+
+// lex src[off, off + len) on its own into out; returns 0 when out of memory
+static int nested_lex(SymTable *out, const char *src, size_t off, size_t len) {
+    Lexer lx;
+    Token t;
+    lexer_init(&lx, src, off + len);   // the body ends where the literal closes
+    lexer_set_range(&lx, off, off + len);
+    if (!symtab_init(out, len)) return 0;
+    while (lexer_next(&lx, &t)) {
+        if (!symtab_push(out, (uint8_t)t.type, (uint8_t)t.flags, (uint32_t)t.off, (uint32_t)t.len,
+                         t.type == T_LEX_ERROR) ||
+            ((t.flags & SYMF_VALUE) && !symtab_push_value(out, t.value))) {
+            symtab_free(out);
+            return 0;
+        }
+    }
+    lexer_destroy(&lx);
+    return 1;
+}
+
+/* The element tokens of the ARRAY or COLLECTION token (type, off, len) over
+   nc's source. Returns NULL for any other token, or when out of memory. The
+   table belongs to the cache and stays valid until nested_free(). */
+static const SymTable *nested_elements(NestedCache *nc, SymType type, size_t off, size_t len) {
+    if ((type != T_ARRAY && type != T_COLLECTION) || off > nc->src_len || len > nc->src_len - off) return NULL;
+    if (nc->cap) {
+        size_t s = nested_slot(nc, (uint32_t)off);
+        if (nc->tab[s]) return nc->tab[s];
+    }
+    if ((nc->count + 1) * 2 > nc->cap && !nested_grow(nc)) return NULL;
+
+    SymTable *el = malloc(sizeof(*el));
+    if (!el) return NULL;
+    if (!nested_lex(el, nc->src, off, len)) {
+        free(el);
+        return NULL;
+    }
+    size_t s = nested_slot(nc, (uint32_t)off);
+    nc->key[s] = (uint32_t)off;
+    nc->tab[s] = el;
+    nc->count++;
+    return el;
+}
+
+#endif // NESTED_H
@@ -0,0 +1,251 @@
+// Numeric and temporal literals: INT, FLOAT, TIME, DATE, TIMESTAMP.
+// A literal is the run of digits, '.', ':', '-' and blanks that starts at a
+// digit. numlit_scan() reads it once, byte by byte, and collects everything
+// both the classification and the value need, so neither looks at the text
+// again:
+//
+//     NumScan ns;
+//     end = numlit_scan(&ns, p, src_end, MAX_LEX - 1);   // end of the run
+//     NumClass nc = numlit_classify(&ns);
+//     LitValue v;
+//     if (numlit_value(&ns, nc, p, &v)) ...;             // well-formed literal
+//
+// The classification is the lexer's long-standing one, with its limits: only
+// the first max bytes of a run count, and the date and time halves of a
+// timestamp are judged on their first 63 and 127 bytes. It is loose (a DATE
+// is anything of 8+ bytes with two dashes), so a literal only gets a value
+// when its text has the exact shape of its type:
+//
+//     INT        digits                     the value (up to INT64_MAX)
+//     FLOAT      digits '.' [digits]        the nearest double
+//     TIME       H[H]:MM[:SS]               seconds since midnight
+//     DATE       Y[YYYYY]-M[M]-D[D]         days since 1970-01-01
+//     TIMESTAMP  DATE blanks TIME           seconds since 1970-01-01 00:00:00
+//
+// Dates are proleptic Gregorian and timestamps carry no time zone.
+
+#ifndef NUMLIT_H
+#define NUMLIT_H
+
+#include <float.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simd.h"
+
+typedef union {
+    int64_t i;    // INT, TIME, DATE, TIMESTAMP
+    double f;     // FLOAT
+} LitValue;
+
+typedef enum {
+    NL_INT, NL_FLOAT, NL_TIME, NL_DATE, NL_TIMESTAMP,
+    NL_DATE_SPLIT,   // DATE up to the first blank; the rest is lexed again
+    NL_ERROR
+} NumClass;
+
+#define NUMLIT_FIELDS 6   // digit groups a literal with a value can have (a TIMESTAMP)
+
+typedef struct {
+    uint64_t v;        // if !over
+    uint16_t digits;   // including leading zeros
+    bool over;         // more than 64 bits
+    char sep;          // separator before the group: 0 for the first, else - : . or ' ' for blanks
+} NumField;
+
+typedef struct {
+    size_t len;              // length once trailing blanks are trimmed
+    size_t space;            // offset of the first blank, SIZE_MAX if none
+    unsigned dashes, colons, dots;
+    unsigned left_dashes;    // dashes in the first 63 bytes, before that blank
+    unsigned right_colons;   // colons in the 127 bytes after it
+    int nfields;             // -1: the text cannot have a value
+    int left_fields;         // nfields at the first blank (-1 as above), for a DATE cut there
+    char dangling;           // separator the trimmed text ends in, 0 if a digit
+    NumField field[NUMLIT_FIELDS];
+} NumScan;
+
+/* Scan the literal starting at the digit *p. Returns the end of the run of
+   number characters; bytes after the first max are skipped unread. */
+static const char *numlit_scan(NumScan *ns, const char *p, const char *end, size_t max) {
+    const char *s = p, *stop = (size_t)(end - p) > max ? p + max : end;
+    ns->len = 0;
+    ns->space = SIZE_MAX;
+    ns->dashes = ns->colons = ns->dots = 0;
+    ns->left_dashes = ns->right_colons = 0;
+    ns->nfields = ns->left_fields = 0;
+    char sep = 0;        // separator since the last digit ...
+    bool blank = false;  // ... and whether blanks came since
+
+    for (; p < stop; ++p) {
+        unsigned char c = (unsigned char)*p;
+        size_t i = (size_t)(p - s);
+        if ((unsigned char)(c - '0') < 10) {
+            if (sep || blank || i == 0) {   // a new digit group
+                if (sep && blank) ns->nfields = -1;   // "1. 2"
+                if (ns->nfields >= 0 && ns->nfields < NUMLIT_FIELDS)
+                    ns->field[ns->nfields++] = (NumField){0, 0, false, sep ? sep : blank ? ' ' : 0};
+                else
+                    ns->nfields = -1;
+                sep = 0;
+                blank = false;
+            }
+            if (ns->nfields > 0) {
+                NumField *f = &ns->field[ns->nfields - 1];
+                if (f->v > (UINT64_MAX - 9) / 10) f->over = true;
+                else f->v = f->v * 10 + (c - '0');
+                f->digits++;
+            }
+            ns->len = i + 1;
+            continue;
+        }
+        switch (c) {
+        case ' ':
+            if (ns->space == SIZE_MAX) {
+                ns->space = i;
+                ns->left_fields = sep ? -1 : ns->nfields;
+            }
+            blank = true;
+            continue;   // not part of len until something follows it
+        case '-':
+            ns->dashes++;
+            if (ns->space == SIZE_MAX && i < 63) ns->left_dashes++;
+            break;
+        case ':':
+            ns->colons++;
+            if (ns->space != SIZE_MAX && i - ns->space - 1 < 127) ns->right_colons++;
+            break;
+        case '.':
+            ns->dots++;
+            break;
+        default:
+            goto done;
+        }
+        if (sep || blank) ns->nfields = -1;   // two separators in a row
+        sep = (char)c;
+        ns->len = i + 1;
+    }
+    if (p == stop && p < end && simd_is_number((unsigned char)*p)) {
+        ns->nfields = -1;   // longer than max: only the start was classified
+        p = simd_span_number(p, end);
+    }
+done:
+    ns->dangling = sep;
+    return p;
+}
+
+static NumClass numlit_classify(const NumScan *ns) {
+    size_t n = ns->len;
+    if (ns->dashes == 2 && n >= 8) {
+        if (ns->space < n) {
+            size_t left = ns->space < 63 ? ns->space : 63;
+            size_t right = n - ns->space - 1 < 127 ? n - ns->space - 1 : 127;
+            bool date = left >= 8 && ns->left_dashes == 2;
+            if (date && right >= 4 && (ns->right_colons == 1 || ns->right_colons == 2)) return NL_TIMESTAMP;
+            return date ? NL_DATE_SPLIT : NL_ERROR;
+        }
+        return NL_DATE;
+    }
+    if ((ns->colons == 1 || ns->colons == 2) && n >= 4) return NL_TIME;
+    if (ns->dots) return NL_FLOAT;
+    return NL_INT;
+}
+
+// days from 1970-01-01 to y-m-d in the proleptic Gregorian calendar
+static int64_t numlit_days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    unsigned yoe = (unsigned)(y - era * 400);
+    unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+// fields f[0..2] as Y-M-D: days since 1970-01-01
+static bool numlit_date(const NumField *f, int64_t *days) {
+    static const unsigned char mdays[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (f[1].sep != '-' || f[2].sep != '-') return false;
+    if (f[0].digits > 6 || f[1].digits > 2 || f[2].digits > 2) return false;
+    uint64_t y = f[0].v, m = f[1].v, d = f[2].v;
+    if (m < 1 || m > 12 || d < 1 || d > mdays[m - 1]) return false;
+    if (m == 2 && d == 29 && !(y % 4 == 0 && (y % 100 != 0 || y % 400 == 0))) return false;
+    *days = numlit_days_from_civil((int64_t)y, (unsigned)m, (unsigned)d);
+    return true;
+}
+
+// n fields from f as H[H]:MM[:SS] (the separator before H is not looked at): seconds since midnight
+static bool numlit_time(const NumField *f, int n, int64_t *secs) {
+    if (n != 2 && n != 3) return false;
+    uint64_t s = 0;
+    for (int k = 0; k < n; ++k) {
+        if (k ? f[k].sep != ':' || f[k].digits != 2 || f[k].v > 59 : f[k].digits > 2 || f[k].v > 23) return false;
+        s = s * 60 + f[k].v;
+    }
+    if (n == 2) s *= 60;
+    *secs = (int64_t)s;
+    return true;
+}
+
+// text[0, len) is digits '.' [digits] made of fields ip and, if fp, fp
+static bool numlit_float(const NumField *ip, const NumField *fp, const char *text, size_t len, double *out) {
+    static const double pow10[23] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    unsigned fd = fp ? fp->digits : 0;
+    /* exact when the digits fit a double's mantissa and the scale is an exact
+       power of ten: one correctly rounded division */
+    if (ip->digits + fd <= 19 && fd <= 22) {
+        uint64_t m = ip->v;
+        for (unsigned k = 0; k < fd; ++k) m *= 10;
+        m += fp ? fp->v : 0;
+        if (m <= (uint64_t)1 << 53) {
+            *out = (double)m / pow10[fd];
+            return true;
+        }
+    }
+    /* otherwise strtod(), on a terminated copy: the source goes on past the literal */
+    char small[64], *buf = len < sizeof(small) ? small : malloc(len + 1);
+    if (!buf) return false;
+    memcpy(buf, text, len);
+    buf[len] = '\0';
+    *out = strtod(buf, NULL);
+    if (buf != small) free(buf);
+    return *out <= DBL_MAX;
+}
+
+/* The value of the literal text (which ns describes) as the type nc, if its
+   text has that type's exact shape. */
+static bool numlit_value(const NumScan *ns, NumClass nc, const char *text, LitValue *v) {
+    const NumField *f = ns->field;
+    int n = ns->nfields;
+    int64_t days, secs;
+    if (n <= 0 && nc != NL_DATE_SPLIT) return false;
+
+    switch (nc) {
+    case NL_INT:
+        if (n != 1 || ns->dangling || f[0].over || f[0].v > INT64_MAX) return false;
+        v->i = (int64_t)f[0].v;
+        return true;
+    case NL_FLOAT:
+        if (n == 1 ? ns->dangling != '.' : n != 2 || f[1].sep != '.' || ns->dangling) return false;
+        return numlit_float(&f[0], n == 2 ? &f[1] : NULL, text, ns->len, &v->f);
+    case NL_TIME:
+        return !ns->dangling && numlit_time(f, n, &v->i);
+    case NL_DATE:
+        return n == 3 && !ns->dangling && numlit_date(f, &v->i);
+    case NL_DATE_SPLIT:   // what follows the blank is not part of this token
+        return ns->left_fields == 3 && numlit_date(f, &v->i);
+    case NL_TIMESTAMP:
+        if (n < 5 || ns->dangling || f[3].sep != ' ' || !numlit_date(f, &days) || !numlit_time(f + 3, n - 3, &secs))
+            return false;
+        v->i = days * 86400 + secs;
+        return true;
+    case NL_ERROR:
+        break;
+    }
+    return false;
+}
+
+#endif // NUMLIT_H
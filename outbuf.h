@@ -0,0 +1,251 @@
+// Buffered output writer for SymbolTable.txt, the project summary and the
+// JSON Lines output.
+// Rows are assembled in one large reusable buffer with hand-rolled integer
+// and padding code, and the buffer goes to the file descriptor in a few big
+// write() calls instead of one stdio call per token. The bytes are the same
+// ones the printf formats ("%6u", "%-15s", "%.*s") would produce.
+
+#ifndef OUTBUF_H
+#define OUTBUF_H
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+  #include <fcntl.h>
+  #include <io.h>
+  #define ob_sys_open(p) _open((p), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0666)
+  #define ob_sys_write(fd, b, n) _write((fd), (b), (unsigned)(n))
+  #define ob_sys_close _close
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+  #define ob_sys_open(p) open((p), O_WRONLY | O_CREAT | O_TRUNC, 0666)
+  #define ob_sys_write(fd, b, n) write((fd), (b), (n))
+  #define ob_sys_close close
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+  #define OB_MAYBE_UNUSED __attribute__((unused))   // helpers not every includer calls
+#else
+  #define OB_MAYBE_UNUSED
+#endif
+
+#define OB_BUF_SIZE ((size_t)1 << 20)
+
+typedef struct {
+    int fd;
+    int own_fd;     // 1 = opened here and closed by ob_close(); 0 = stdout
+    char *buf;
+    size_t len;     // bytes waiting in buf
+    size_t cap;
+    int failed;     // a write() failed; later output is dropped
+    unsigned long long written;   // bytes handed to the descriptor so far
+} OutBuf;
+
+// hand len bytes to the descriptor, retrying short writes
+static void ob_write_fd(OutBuf *o, const char *p, size_t len) {
+    while (len > 0 && !o->failed) {
+        size_t chunk = len > ((size_t)1 << 30) ? ((size_t)1 << 30) : len;
+        long n = (long)ob_sys_write(o->fd, p, chunk);
+        if (n <= 0) { o->failed = 1; break; }
+        o->written += (unsigned long long)n;
+        p += n;
+        len -= (size_t)n;
+    }
+}
+
+static void ob_flush(OutBuf *o) {
+    ob_write_fd(o, o->buf, o->len);
+    o->len = 0;
+}
+
+// path "-" writes to standard output; returns 0 on failure (errno set)
+static int ob_open(OutBuf *o, const char *path) {
+    memset(o, 0, sizeof(*o));
+    if (strcmp(path, "-") == 0) {
+        fflush(stdout);   // keep anything stdio already buffered in front
+        o->fd = 1;
+    } else {
+        o->fd = ob_sys_open(path);
+        if (o->fd < 0) return 0;
+        o->own_fd = 1;
+    }
+    o->cap = OB_BUF_SIZE;
+    o->buf = malloc(o->cap);
+    if (!o->buf) {
+        if (o->own_fd) ob_sys_close(o->fd);
+        return 0;
+    }
+    return 1;
+}
+
+// flush, release the buffer and close the file; returns 0 if anything was lost
+static int ob_close(OutBuf *o) {
+    ob_flush(o);
+    free(o->buf);
+    o->buf = NULL;
+    int ok = !o->failed;
+    if (o->own_fd && ob_sys_close(o->fd) != 0) ok = 0;
+    return ok;
+}
+
+// room for at least n more bytes in buf, flushing first if needed
+static inline char *ob_reserve(OutBuf *o, size_t n) {
+    if (o->cap - o->len < n) ob_flush(o);
+    return o->buf + o->len;
+}
+
+static inline void ob_write(OutBuf *o, const char *p, size_t n) {
+    if (n >= o->cap) {   // larger than the whole buffer: write straight through
+        ob_flush(o);
+        ob_write_fd(o, p, n);
+        return;
+    }
+    memcpy(ob_reserve(o, n), p, n);
+    o->len += n;
+}
+
+#define ob_lit(o, s) ob_write((o), (s), sizeof(s) - 1)
+
+static inline void ob_putc(OutBuf *o, char c) {
+    *ob_reserve(o, 1) = c;
+    o->len++;
+}
+
+static const char ob_digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// v right-aligned in a field of width bytes, like "%*lu"
+static inline void ob_uint(OutBuf *o, unsigned long v, int width) {
+    char tmp[24];
+    char *e = tmp + sizeof(tmp), *p = e;
+    while (v >= 100) {
+        unsigned d = (unsigned)(v % 100) * 2;
+        v /= 100;
+        *--p = ob_digit_pairs[d + 1];
+        *--p = ob_digit_pairs[d];
+    }
+    if (v >= 10) {
+        *--p = ob_digit_pairs[v * 2 + 1];
+        *--p = ob_digit_pairs[v * 2];
+    } else {
+        *--p = (char)('0' + v);
+    }
+    size_t n = (size_t)(e - p), pad = (size_t)width > n ? (size_t)width - n : 0;
+    char *d = ob_reserve(o, pad + n);
+    memset(d, ' ', pad);
+    memcpy(d + pad, p, n);
+    o->len += pad + n;
+}
+
+// s left-aligned in a field of width bytes, like "%-*s"
+static inline void ob_str_pad(OutBuf *o, const char *s, size_t n, int width) {
+    size_t pad = (size_t)width > n ? (size_t)width - n : 0;
+    ob_write(o, s, n);
+    memset(ob_reserve(o, pad), ' ', pad);
+    o->len += pad;
+}
+
+// n bytes of s as "%.*s" prints them: up to the first NUL
+static inline void ob_bytes(OutBuf *o, const char *s, size_t n) {
+    const char *z = memchr(s, '\0', n);
+    ob_write(o, s, z ? (size_t)(z - s) : n);
+}
+
+// length of the valid UTF-8 sequence at p[0, n), or 0 if it is not one
+static inline size_t ob_utf8_len(const unsigned char *p, size_t n) {
+    unsigned c = p[0];
+    size_t need;
+    unsigned min;
+    if (c < 0xC2) return 0;   // continuation byte or overlong lead
+    else if (c < 0xE0) { need = 2; min = 0x80; }
+    else if (c < 0xF0) { need = 3; min = 0x800; }
+    else if (c < 0xF5) { need = 4; min = 0x10000; }
+    else return 0;
+    if (n < need) return 0;
+    unsigned cp = c & (0x3F >> (need - 1));
+    for (size_t i = 1; i < need; ++i) {
+        if ((p[i] & 0xC0) != 0x80) return 0;
+        cp = cp << 6 | (p[i] & 0x3F);
+    }
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return 0;
+    return need;
+}
+
+/* s[0, n) as a quoted JSON string. Runs of plain ASCII are copied as they
+   are; quotes, backslashes and control bytes are escaped, and bytes that are
+   not valid UTF-8 become U+FFFD so the output is always valid JSON. */
+static OB_MAYBE_UNUSED void ob_json_str(OutBuf *o, const char *s, size_t n) {
+    static const char hex[] = "0123456789abcdef";
+    const unsigned char *p = (const unsigned char *)s, *end = p + n;
+    ob_putc(o, '"');
+    while (p < end) {
+        const unsigned char *run = p;
+        while (p < end && *p >= 0x20 && *p < 0x80 && *p != '"' && *p != '\\') p++;
+        ob_write(o, (const char *)run, (size_t)(p - run));
+        if (p == end) break;
+
+        unsigned c = *p;
+        if (c >= 0x80) {
+            size_t k = ob_utf8_len(p, (size_t)(end - p));
+            if (k) ob_write(o, (const char *)p, k);
+            else ob_lit(o, "\\ufffd");
+            p += k ? k : 1;
+            continue;
+        }
+        char *d = ob_reserve(o, 6);
+        d[0] = '\\';
+        switch (c) {
+            case '"':  d[1] = '"'; o->len += 2; break;
+            case '\\': d[1] = '\\'; o->len += 2; break;
+            case '\n': d[1] = 'n'; o->len += 2; break;
+            case '\r': d[1] = 'r'; o->len += 2; break;
+            case '\t': d[1] = 't'; o->len += 2; break;
+            case '\b': d[1] = 'b'; o->len += 2; break;
+            case '\f': d[1] = 'f'; o->len += 2; break;
+            default:
+                memcpy(d + 1, "u00", 3);
+                d[4] = hex[c >> 4];
+                d[5] = hex[c & 15];
+                o->len += 6;
+        }
+        p++;
+    }
+    ob_putc(o, '"');
+}
+
+// printf into the buffer, for the few lines that are not per-token
+static OB_MAYBE_UNUSED void ob_printf(OutBuf *o, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    size_t room = o->cap - o->len;
+    int n = vsnprintf(o->buf + o->len, room, fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    if ((size_t)n < room) { o->len += (size_t)n; return; }
+
+    /* did not fit: flush and format again, through a temporary if it never will */
+    ob_flush(o);
+    va_start(ap, fmt);
+    if ((size_t)n < o->cap) {
+        vsnprintf(o->buf, o->cap, fmt, ap);
+        o->len = (size_t)n;
+    } else {
+        char *tmp = malloc((size_t)n + 1);
+        if (tmp) {
+            vsnprintf(tmp, (size_t)n + 1, fmt, ap);
+            ob_write_fd(o, tmp, (size_t)n);
+            free(tmp);
+        } else {
+            o->failed = 1;
+        }
+    }
+    va_end(ap);
+}
+
+#endif // OUTBUF_H
@@ -0,0 +1,227 @@
+// Intra-file parallel lexing.
+// The input is cut into chunks at line starts and every chunk is lexed on
+// its own thread as if it began a fresh file. A sequential reconcile pass
+// then repairs the two things that assumption can get wrong:
+//
+//  - a construct that spans lines (/* */ comment, """ TEXT """, a string,
+//    `SECURE`, { } collection or [ ] array) may begin in one chunk and run
+//    into the next. The lexer that owns the frontier keeps scanning past
+//    its chunk until it lands on an offset where the next chunk's lexer
+//    also started a token; from there on both token streams agree, and
+//    the next chunk's tokens before that point are dropped.
+//  - the unary/binary choice for + and - (prev_allows_unary()) looks at the
+//    previous meaningful token, which may sit in an earlier chunk. Only the
+//    first meaningful token after a chunk start can be affected, so the
+//    lexer flags every context-typed sign (SYMF_SIGN) and reconcile retypes
+//    that one token from the real previous state.
+//
+// The merged table is identical to a sequential lexer_next() run.
+
+#ifndef PARLEX_H
+#define PARLEX_H
+
+#include "lexer.h"
+#include "pool.h"
+#include "symtab.h"
+
+#ifndef PAR_MIN_CHUNK
+  #define PAR_MIN_CHUNK ((size_t)256 << 10)   // smaller chunks are not worth a thread
+#endif
+#define PAR_CHUNKS_PER_THREAD 4
+#define PAR_SYNC_WINDOW 4096   // token starts remembered per chunk for resynchronising
+
+typedef struct {
+    size_t begin, end;      // [begin, end): tokens starting here belong to the chunk
+    Lexer lx;               // borrows the shared source buffer
+    SymTable tab;           // offsets are absolute, so tables concatenate as they are
+
+    size_t starts[PAR_SYNC_WINDOW];   // offsets of the first token starts in the chunk
+    uint32_t start_tok[PAR_SYNC_WINDOW]; // ... and the index of the token started there
+    size_t nstarts;
+
+    long last_meaningful;   // index of the last non-trivia token, -1 if none
+    size_t drop;            // tokens [0, drop) were superseded during reconcile
+    int failed;
+} ParChunk;
+
+static bool par_is_trivia(uint8_t t) {
+    return t == T_WHITESPACE || t == T_NEWLINE || t == T_COMMENT;
+}
+
+// append a token lexed by ch's lexer to ch's table
+static int par_push(ParChunk *ch, const Token *t) {
+    if (!symtab_push(&ch->tab, (uint8_t)t->type, (uint8_t)t->flags, (uint32_t)t->off, (uint32_t)t->len,
+                     t->type == T_LEX_ERROR) ||
+        ((t->flags & SYMF_VALUE) && !symtab_push_value(&ch->tab, t->value)))
+        return 0;
+    if (!par_is_trivia((uint8_t)t->type)) ch->last_meaningful = (long)ch->tab.count - 1;
+    return 1;
+}
+
+static void par_lex_chunk(void *task, int worker, void *ctx) {
+    (void)worker; (void)ctx;
+    ParChunk *ch = task;
+    ch->last_meaningful = -1;
+    if (!symtab_init(&ch->tab, ch->end - ch->begin)) { ch->failed = 1; return; }
+
+    lexer_set_range(&ch->lx, ch->begin, ch->end);
+    Token t;
+    for (;;) {
+        /* with an empty queue the next token starts a new scan at the cursor */
+        bool at_start = ch->lx.qhead == ch->lx.qtail;
+        size_t pos = ch->lx.src.pos;
+        if (!lexer_next(&ch->lx, &t)) break;
+        if (at_start && ch->nstarts < PAR_SYNC_WINDOW) {
+            ch->starts[ch->nstarts] = pos;
+            ch->start_tok[ch->nstarts] = (uint32_t)ch->tab.count;
+            ch->nstarts++;
+        }
+        if (!par_push(ch, &t)) { ch->failed = 1; return; }
+    }
+}
+
+// Index into ch->starts of a token start at pos, or -1.
+static long par_find_start(const ParChunk *ch, size_t pos) {
+    size_t lo = 0, hi = ch->nstarts;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (ch->starts[mid] < pos) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo < ch->nstarts && ch->starts[lo] == pos) ? (long)lo : -1;
+}
+
+// Sequential repair pass, see the header comment. Returns 0 when out of memory.
+static int par_reconcile(ParChunk *chunks, size_t n) {
+    size_t carrier = 0;                         // chunk whose lexer owns the frontier
+    SymType carry_type = chunks[0].lx.prev_type; // real lexer state at the frontier
+    bool carry_empty = chunks[0].lx.prev_lexeme_empty;
+
+    for (size_t k = 1; k < n; ++k) {
+        ParChunk *c = &chunks[carrier];
+        ParChunk *nx = &chunks[k];
+        long sync = -1;
+
+        c->lx.prev_type = carry_type;
+        c->lx.prev_lexeme_empty = carry_empty;
+        if (c->lx.src.pos == nx->begin) {
+            sync = 0;
+        } else {
+            /* the carrier's last token ran into this chunk: keep scanning until
+               it reaches a token start this chunk also found, or its end */
+            c->lx.limit = nx->end;
+            Token t;
+            for (;;) {
+                if (c->lx.qhead == c->lx.qtail) {
+                    if (c->lx.src.pos >= nx->end) break;
+                    if ((sync = par_find_start(nx, c->lx.src.pos)) >= 0) break;
+                }
+                if (!lexer_next(&c->lx, &t)) break;
+                if (!par_push(c, &t)) return 0;
+            }
+            carry_type = c->lx.prev_type;
+            carry_empty = c->lx.prev_lexeme_empty;
+        }
+
+        if (sync < 0) {
+            nx->drop = nx->tab.count;   // swallowed whole by the carrier
+            continue;
+        }
+
+        nx->drop = nx->start_tok[sync];
+        SymTable *tab = &nx->tab;
+        size_t m = nx->drop;
+        while (m < tab->count && par_is_trivia(tab->type[m])) m++;
+        if (m < tab->count && (tab->flags[m] & SYMF_SIGN))
+            tab->type[m] = (uint8_t)(allows_unary_after(carry_type, carry_empty) ? T_UNARY_OP : T_ARITH_OP);
+        if (nx->last_meaningful >= (long)nx->drop) {
+            carry_type = nx->last_meaningful == (long)m ? (SymType)tab->type[m] : nx->lx.prev_type;
+            carry_empty = nx->lx.prev_lexeme_empty;
+        }
+        carrier = k;
+    }
+    return 1;
+}
+
+// Concatenate the surviving tokens of every chunk into out.
+static int par_merge(ParChunk *chunks, size_t n, SymTable *out, size_t source_len) {
+    size_t total = 0, errs = 0, vals = 0;
+    for (size_t k = 0; k < n; ++k) total += chunks[k].tab.count - chunks[k].drop;
+    if (!symtab_init(out, source_len) || !symtab_reserve(out, total)) return 0;
+    for (size_t k = 0; k < n; ++k) {
+        errs += chunks[k].tab.errcount;
+        vals += chunks[k].tab.valcount;
+    }
+    out->errs = malloc((errs ? errs : 1) * sizeof(*out->errs));
+    if (!out->errs || !symtab_reserve_values(out, vals ? vals : 1)) return 0;
+    out->errcap = errs;
+
+    for (size_t k = 0; k < n; ++k) {
+        const SymTable *t = &chunks[k].tab;
+        size_t from = chunks[k].drop, cnt = t->count - from, at = out->count;
+        memcpy(out->type + at, t->type + from, cnt);
+        memcpy(out->flags + at, t->flags + from, cnt);
+        memcpy(out->off + at, t->off + from, cnt * sizeof(uint32_t));
+        memcpy(out->len + at, t->len + from, cnt * sizeof(uint32_t));
+        for (size_t e = 0; e < t->errcount; ++e)
+            if (t->errs[e] >= from) out->errs[out->errcount++] = (uint32_t)(at + t->errs[e] - from);
+        for (size_t v = 0; v < t->valcount; ++v)
+            if (t->vidx[v] >= from) {
+                out->vidx[out->valcount] = (uint32_t)(at + t->vidx[v] - from);
+                out->vals[out->valcount++] = t->vals[v];
+            }
+        out->count += cnt;
+    }
+    return 1;
+}
+
+// Lex the whole source of lex into out using up to threads threads.
+// Returns NULL or a reason for failing, like lex_into_table().
+static const char *lex_into_table_parallel(Lexer *lex, SymTable *out, int threads) {
+    const char *data = lex->src.data;
+    size_t len = lex->src.len;
+    if (len > UINT32_MAX) return "input is larger than 4 GB; use --stream";
+
+    size_t want = (size_t)threads * PAR_CHUNKS_PER_THREAD;
+    if (want > len / PAR_MIN_CHUNK) want = len / PAR_MIN_CHUNK;
+    if (want < 1) want = 1;
+
+    ParChunk *chunks = calloc(want, sizeof(*chunks));
+    void **tasks = calloc(want, sizeof(void *));
+    if (!chunks || !tasks) { free(chunks); free(tasks); return "out of memory"; }
+
+    /* cut at the first line start at or after each even split point */
+    size_t n = 0, begin = 0;
+    while (begin < len && n < want) {
+        size_t end = len;
+        if (n + 1 < want) {
+            size_t target = len / want * (n + 1);
+            if (target < begin) target = begin;
+            const char *nl = memchr(data + target, '\n', len - target);
+            end = nl ? (size_t)(nl - data) + 1 : len;
+        }
+        lexer_init(&chunks[n].lx, data, len);
+        chunks[n].begin = begin;
+        chunks[n].end = end;
+        tasks[n] = &chunks[n];
+        n++;
+        begin = end;
+    }
+
+    const char *failure = NULL;
+    if (!pool_run(threads, tasks, n, par_lex_chunk, NULL)) failure = "could not start worker threads";
+    for (size_t k = 0; !failure && k < n; ++k)
+        if (chunks[k].failed) failure = "out of memory";
+
+    if (!failure && (!par_reconcile(chunks, n) || !par_merge(chunks, n, out, len))) failure = "out of memory";
+
+    for (size_t k = 0; k < n; ++k) {
+        symtab_free(&chunks[k].tab);
+        lexer_destroy(&chunks[k].lx);
+    }
+    free(chunks);
+    free(tasks);
+    return failure;
+}
+
+#endif // PARLEX_H
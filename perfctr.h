@@ -0,0 +1,142 @@
+// Hardware performance counters for simple_lex --perf (Linux only).
+// One perf_event_open() group per process, counting user-space work of the
+// calling thread: cycles, instructions, branch misses, L1D and last-level
+// cache read misses, and page faults. The group is read with a single
+// read() call, so a phase costs two system calls however many events it
+// holds; with exclude_kernel those calls themselves are not counted.
+//
+//     PerfCounters pc;
+//     const char *why = pc_open(&pc);      // NULL, or why nothing could be counted
+//     uint64_t a[PC_COUNT], b[PC_COUNT];
+//     pc_read(&pc, a);  ...work...  pc_read(&pc, b);   // b[k] - a[k] per event
+//     pc_close(&pc);
+//
+// Events the machine does not offer (virtual machines often have no PMU,
+// and the cache events are model-specific) are left out; pc.have[k] says
+// which ones are counted. The group is pinned, and events are dropped from
+// the end until it can be scheduled, so counts are never multiplexed
+// estimates.
+
+#ifndef PERFCTR_H
+#define PERFCTR_H
+
+#include <stdint.h>
+#include <string.h>
+
+enum { PC_CYCLES, PC_INSTRUCTIONS, PC_BRANCH_MISSES, PC_L1D_MISSES, PC_LLC_MISSES, PC_PAGE_FAULTS, PC_COUNT };
+
+static const char *const pc_names[PC_COUNT] = {
+    "cycles", "instructions", "branch-misses", "L1D-misses", "LLC-misses", "page-faults",
+};
+
+typedef struct {
+    int nfd;
+    int fd[PC_COUNT];      // fd[0] leads the group
+    int event[PC_COUNT];   // which PC_* fd[i] counts, in group read order
+    int have[PC_COUNT];
+} PerfCounters;
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define PC_CACHE(cache, op, result) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_##op << 8) | (PERF_COUNT_HW_CACHE_RESULT_##result << 16))
+
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} pc_events[PC_COUNT] = {
+    [PC_CYCLES]        = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    [PC_INSTRUCTIONS]  = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    [PC_BRANCH_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    [PC_L1D_MISSES]    = {PERF_TYPE_HW_CACHE, PC_CACHE(PERF_COUNT_HW_CACHE_L1D, READ, MISS)},
+    [PC_LLC_MISSES]    = {PERF_TYPE_HW_CACHE, PC_CACHE(PERF_COUNT_HW_CACHE_LL, READ, MISS)},
+    [PC_PAGE_FAULTS]   = {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+static void pc_close(PerfCounters *pc) {
+    for (int i = pc->nfd; i-- > 0;) close(pc->fd[i]);
+    memset(pc, 0, sizeof(*pc));
+}
+
+// open the events in want[0, n) as one group; returns how many opened
+static int pc_open_group(PerfCounters *pc, const int *want, int n, int *first_errno) {
+    memset(pc, 0, sizeof(*pc));
+    for (int i = 0; i < n; ++i) {
+        struct perf_event_attr a;
+        memset(&a, 0, sizeof(a));
+        a.size = sizeof(a);
+        a.type = pc_events[want[i]].type;
+        a.config = pc_events[want[i]].config;
+        a.read_format = PERF_FORMAT_GROUP;
+        a.exclude_kernel = 1;
+        a.exclude_hv = 1;
+        a.disabled = pc->nfd == 0;   // the leader starts the whole group
+        a.pinned = pc->nfd == 0;
+        int fd = (int)syscall(SYS_perf_event_open, &a, 0, -1, pc->nfd ? pc->fd[0] : -1, 0);
+        if (fd < 0) {
+            if (!*first_errno) *first_errno = errno;
+            continue;
+        }
+        pc->fd[pc->nfd] = fd;
+        pc->event[pc->nfd++] = want[i];
+        pc->have[want[i]] = 1;
+    }
+    return pc->nfd;
+}
+
+static int pc_read(const PerfCounters *pc, uint64_t out[PC_COUNT]) {
+    uint64_t buf[1 + PC_COUNT];
+    memset(out, 0, PC_COUNT * sizeof(*out));
+    if (pc->nfd == 0 || read(pc->fd[0], buf, sizeof(buf)) < (long)((1 + pc->nfd) * sizeof(uint64_t))) return 0;
+    for (int i = 0; i < pc->nfd && i < (int)buf[0]; ++i) out[pc->event[i]] = buf[1 + i];
+    return 1;
+}
+
+/* Open and start as many events as can run together. Returns NULL, or the
+   reason no event at all could be opened. */
+static const char *pc_open(PerfCounters *pc) {
+    int err = 0;
+    /* the first nhw hardware events plus page faults; fewer hardware
+       events each time the pinned group cannot be scheduled */
+    for (int nhw = PC_PAGE_FAULTS; nhw >= 0; --nhw) {
+        int want[PC_COUNT];
+        for (int k = 0; k < nhw; ++k) want[k] = k;
+        want[nhw] = PC_PAGE_FAULTS;
+        if (!pc_open_group(pc, want, nhw + 1, &err)) break;
+        ioctl(pc->fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t v[PC_COUNT];
+        if (pc_read(pc, v)) return NULL;   // a pinned group that cannot be scheduled reads nothing
+        pc_close(pc);
+    }
+    if (err == EACCES || err == EPERM) return "perf_event_open: not permitted (see /proc/sys/kernel/perf_event_paranoid)";
+    if (err == ENOENT || err == EOPNOTSUPP || err == ENODEV) return "perf_event_open: no hardware counters here";
+    if (err == ENOSYS) return "perf_event_open: not supported by this kernel";
+    return err ? strerror(err) : "perf_event_open: no counters available";
+}
+
+#else
+
+static const char *pc_open(PerfCounters *pc) {
+    memset(pc, 0, sizeof(*pc));
+    return "performance counters are only supported on Linux";
+}
+
+static int pc_read(const PerfCounters *pc, uint64_t out[PC_COUNT]) {
+    (void)pc;
+    memset(out, 0, PC_COUNT * sizeof(*out));
+    return 0;
+}
+
+static void pc_close(PerfCounters *pc) {
+    memset(pc, 0, sizeof(*pc));
+}
+
+#endif // __linux__
+
+#endif // PERFCTR_H
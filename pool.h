@@ -0,0 +1,116 @@
+// Work-stealing thread pool for batch lexing.
+// Each worker owns a deque of tasks. Tasks are dealt out round-robin in the
+// order given (callers pass them largest first), a worker takes from the
+// front of its own deque and, once that is empty, steals from the back of
+// another worker's deque, so the small leftovers are what gets moved around
+// at the end of a run. Task sets are fixed up front: nothing is spawned
+// while the pool runs, so the pool is done when every deque is empty.
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <unistd.h>
+#endif
+
+typedef void (*pool_fn)(void *task, int worker, void *ctx);
+
+typedef struct {
+    pthread_mutex_t lock;
+    void **items;
+    size_t head, tail;      // live tasks are items[head..tail)
+} PoolDeque;
+
+typedef struct {
+    PoolDeque *deques;
+    int nworkers;
+    pool_fn fn;
+    void *ctx;
+} Pool;
+
+typedef struct {
+    Pool *pool;
+    int id;
+} PoolWorker;
+
+static int pool_default_threads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors > 0 ? (int)si.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+static void *pool_take(PoolDeque *d, int from_back) {
+    void *t = NULL;
+    pthread_mutex_lock(&d->lock);
+    if (d->head < d->tail) t = from_back ? d->items[--d->tail] : d->items[d->head++];
+    pthread_mutex_unlock(&d->lock);
+    return t;
+}
+
+static void *pool_worker_main(void *arg) {
+    PoolWorker *w = arg;
+    Pool *p = w->pool;
+    for (;;) {
+        void *t = pool_take(&p->deques[w->id], 0);
+        for (int k = 1; !t && k < p->nworkers; ++k)
+            t = pool_take(&p->deques[(w->id + k) % p->nworkers], 1);
+        if (!t) break;
+        p->fn(t, w->id, p->ctx);
+    }
+    return NULL;
+}
+
+// Run fn over every task on nworkers threads and wait for all of them.
+// Returns 0 if the threads or deques could not be set up.
+static int pool_run(int nworkers, void **tasks, size_t ntasks, pool_fn fn, void *ctx) {
+    if (nworkers < 1) nworkers = 1;
+    if ((size_t)nworkers > ntasks) nworkers = ntasks ? (int)ntasks : 1;
+
+    Pool p = { calloc((size_t)nworkers, sizeof(PoolDeque)), nworkers, fn, ctx };
+    PoolWorker *ws = calloc((size_t)nworkers, sizeof(PoolWorker));
+    pthread_t *th = calloc((size_t)nworkers, sizeof(pthread_t));
+    int ok = p.deques && ws && th;
+
+    for (int i = 0; ok && i < nworkers; ++i) {
+        PoolDeque *d = &p.deques[i];
+        d->items = malloc((ntasks / (size_t)nworkers + 1) * sizeof(void *));
+        if (!d->items) { ok = 0; break; }
+        pthread_mutex_init(&d->lock, NULL);
+    }
+    for (size_t i = 0; ok && i < ntasks; ++i) {
+        PoolDeque *d = &p.deques[i % (size_t)nworkers];
+        d->items[d->tail++] = tasks[i];
+    }
+
+    int started = 0;
+    for (; ok && started < nworkers; ++started) {
+        ws[started].pool = &p;
+        ws[started].id = started;
+        // worker 0 runs on the calling thread
+        if (started > 0 && pthread_create(&th[started], NULL, pool_worker_main, &ws[started]) != 0) break;
+    }
+    if (ok && started > 0) pool_worker_main(&ws[0]);
+    for (int i = 1; i < started; ++i) pthread_join(th[i], NULL);
+
+    for (int i = 0; p.deques && i < nworkers; ++i) {
+        if (!p.deques[i].items) continue;
+        pthread_mutex_destroy(&p.deques[i].lock);
+        free(p.deques[i].items);
+    }
+    free(p.deques);
+    free(ws);
+    free(th);
+    return ok;
+}
+
+#endif // POOL_H
@@ -0,0 +1,190 @@
+// Incremental re-lexing of an edited buffer.
+// Given the token table of the old source and one edit, relex() lexes only
+// the part of the new source the edit can have changed:
+//
+//  - it restarts at the last NEWLINE token before the edit. Such a token is
+//    only produced at the top level, so nothing before it is inside a
+//    comment, TEXT, string, array or collection, and nothing before it looks
+//    at bytes after it. The restart state (the previous meaningful token,
+//    for the unary/binary choice) is read back from the old table.
+//  - it stops at the first NEWLINE past the inserted text whose old
+//    position also held a NEWLINE token. From there both sources are the
+//    same bytes and both lexers are at the start of a line, so the old
+//    tokens only move by the edit's offset delta. As in parlex.h,
+//    the one token that can still differ is the first + or - after the join
+//    (SYMF_SIGN), which is retyped from the new previous token.
+//
+//     RelexResult r;
+//     new_src = relex_apply_edit(old_src, old_len, &edit, &new_len);
+//     if (relex(&tab, new_src, new_len, &edit, &r) == NULL)
+//         relex_splice(&tab, &r);     // tab now describes new_src
+//     relex_free(&r);
+//
+// Old tokens [r.first, r.old_end) are replaced by r.fresh; r.fresh and the
+// shifted tail are exactly what a full lex of the new source would give.
+
+#ifndef RELEX_H
+#define RELEX_H
+
+#include "lexer.h"
+#include "symtab.h"
+
+typedef struct {
+    size_t off;         // start of the edit in the old source
+    size_t removed;     // old bytes replaced
+    const char *text;   // bytes inserted in their place
+    size_t text_len;
+} RelexEdit;
+
+typedef struct {
+    size_t first;       // old tokens [first, old_end) were replaced ...
+    size_t old_end;
+    SymTable fresh;     // ... by these, positioned in the new source
+    long long off_delta;    // added to the offset of every old token from old_end on
+} RelexResult;
+
+// the old source with e applied, in a new heap buffer (NULL when out of memory or e is out of range)
+static char *relex_apply_edit(const char *src, size_t len, const RelexEdit *e, size_t *new_len) {
+    if (e->off > len || e->removed > len - e->off) return NULL;
+    size_t n = len - e->removed + e->text_len;
+    char *out = malloc(n ? n : 1);
+    if (!out) return NULL;
+    memcpy(out, src, e->off);
+    memcpy(out + e->off, e->text, e->text_len);
+    memcpy(out + e->off + e->text_len, src + e->off + e->removed, len - e->off - e->removed);
+    *new_len = n;
+    return out;
+}
+
+static bool relex_is_trivia(uint8_t t) {
+    return t == T_WHITESPACE || t == T_NEWLINE || t == T_COMMENT;
+}
+
+// index of the first token starting at or after off
+static size_t relex_lower_bound(const SymTable *tab, size_t off) {
+    size_t lo = 0, hi = tab->count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (tab->off[mid] < off) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// push a token, with its literal value if v is not NULL
+static int relex_push(SymTable *t, uint8_t type, uint8_t flags, long long off, uint32_t len, const LitValue *v) {
+    return symtab_push(t, type, flags, (uint32_t)off, len, type == T_LEX_ERROR) && (!v || symtab_push_value(t, *v));
+}
+
+static void relex_free(RelexResult *r) {
+    symtab_free(&r->fresh);
+}
+
+/* Re-lex src[0, len), which is the source old was made from with e applied.
+   Returns NULL or a reason for failing; r must be freed with relex_free(). */
+static const char *relex(const SymTable *old, const char *src, size_t len, const RelexEdit *e, RelexResult *r) {
+    memset(r, 0, sizeof(*r));
+    if (len > UINT32_MAX) return "input is larger than 4 GB";
+    if (!symtab_init(&r->fresh, 0)) return "out of memory";
+    size_t ins_end = e->off + e->text_len;   // end of the inserted text in src
+    r->off_delta = (long long)e->text_len - (long long)e->removed;
+
+    size_t k = relex_lower_bound(old, e->off);
+    while (k > 0 && old->type[k - 1] != T_NEWLINE) k--;
+    r->first = k;
+
+    Lexer lx;
+    lexer_init(&lx, src, len);
+    lexer_set_range(&lx, k ? old->off[k - 1] + 1 : 0, len);
+    if (k) {
+        for (size_t i = k; i-- > 0;)
+            if (!relex_is_trivia(old->type[i])) {
+                lx.prev_type = (SymType)old->type[i];
+                lx.prev_lexeme_empty = old->len[i] == 0 || src[old->off[i]] == '\0';
+                break;
+            }
+    }
+
+    Token t;
+    while (lexer_next(&lx, &t)) {
+        if (t.type == T_NEWLINE && t.off >= ins_end) {
+            size_t q = (size_t)((long long)t.off - r->off_delta);
+            size_t j = relex_lower_bound(old, q);
+            while (j < old->count && old->off[j] == q && old->type[j] != T_NEWLINE) j++;
+            if (j < old->count && old->off[j] == q) {
+                r->old_end = j;
+
+                size_t m = j + 1;
+                while (m < old->count && relex_is_trivia(old->type[m])) m++;
+                if (m < old->count && (old->flags[m] & SYMF_SIGN)) {
+                    SymType sign = allows_unary_after(lx.prev_type, lx.prev_lexeme_empty) ? T_UNARY_OP : T_ARITH_OP;
+                    if (sign != old->type[m]) {
+                        /* the join moves to just after the retyped sign */
+                        for (size_t i = j; i <= m; ++i) {
+                            LitValue v;
+                            if (!relex_push(&r->fresh, i == m ? (uint8_t)sign : old->type[i], old->flags[i],
+                                            old->off[i] + r->off_delta, old->len[i],
+                                            symtab_value(old, i, &v) ? &v : NULL))
+                                return "out of memory";
+                        }
+                        r->old_end = m + 1;
+                    }
+                }
+                return NULL;
+            }
+        }
+        if (!relex_push(&r->fresh, (uint8_t)t.type, (uint8_t)t.flags, (long long)t.off, (uint32_t)t.len,
+                        (t.flags & SYMF_VALUE) ? &t.value : NULL))
+            return "out of memory";
+    }
+    r->old_end = old->count;   // ran to the end of the input without meeting the old stream
+    return NULL;
+}
+
+// apply r to the table it was computed from; returns 0 when out of memory
+static int relex_splice(SymTable *tab, const RelexResult *r) {
+    size_t added = r->fresh.count, tail = tab->count - r->old_end;
+    size_t count = r->first + added + tail;
+    size_t vfirst = symtab_value_slot(tab, r->first), vend = symtab_value_slot(tab, r->old_end);
+    size_t vadded = r->fresh.valcount, vtail = tab->valcount - vend;
+    if (!symtab_reserve(tab, count) || !symtab_reserve_values(tab, vfirst + vadded + vtail)) return 0;
+
+#define RELEX_SPLICE(col)                                                                   \
+    memmove(tab->col + r->first + added, tab->col + r->old_end, tail * sizeof(*tab->col)); \
+    memcpy(tab->col + r->first, r->fresh.col, added * sizeof(*tab->col));
+    RELEX_SPLICE(type)
+    RELEX_SPLICE(flags)
+    RELEX_SPLICE(off)
+    RELEX_SPLICE(len)
+#undef RELEX_SPLICE
+    for (size_t i = r->first + added; i < count; ++i) tab->off[i] = (uint32_t)(tab->off[i] + r->off_delta);
+    tab->count = count;
+
+    /* values move with their tokens; the fresh ones are indexed from 0. Either
+       list is still unallocated (NULL) when it has never held a value */
+    if (vtail) {
+        memmove(tab->vidx + vfirst + vadded, tab->vidx + vend, vtail * sizeof(*tab->vidx));
+        memmove(tab->vals + vfirst + vadded, tab->vals + vend, vtail * sizeof(*tab->vals));
+    }
+    if (vadded) memcpy(tab->vals + vfirst, r->fresh.vals, vadded * sizeof(*tab->vals));
+    for (size_t v = 0; v < vadded; ++v) tab->vidx[vfirst + v] = (uint32_t)(r->first + r->fresh.vidx[v]);
+    for (size_t v = vfirst + vadded; v < vfirst + vadded + vtail; ++v)
+        tab->vidx[v] = (uint32_t)(tab->vidx[v] + added - (r->old_end - r->first));
+    tab->valcount = vfirst + vadded + vtail;
+
+    /* error indexes after the edit all moved; rebuild the list */
+    size_t errs = 0;
+    for (size_t i = 0; i < count; ++i) errs += tab->type[i] == T_LEX_ERROR;
+    if (errs > tab->errcap) {
+        uint32_t *ne = realloc(tab->errs, errs * sizeof(*ne));
+        if (!ne) return 0;
+        tab->errs = ne;
+        tab->errcap = errs;
+    }
+    tab->errcount = 0;
+    for (size_t i = 0; i < count; ++i)
+        if (tab->type[i] == T_LEX_ERROR) tab->errs[tab->errcount++] = (uint32_t)i;
+    return 1;
+}
+
+#endif // RELEX_H
@@ -0,0 +1,180 @@
+// Vectorized run scanners for the SIMPLE lexer.
+// Each simd_span_*() returns a pointer to the first byte in [p, end) that is
+// NOT part of the run (end if the run reaches it). They test 32 bytes per
+// step with AVX2 when the CPU has it (checked at run time), 16 with SSE2 on
+// any x86-64, and finish with a plain byte loop; other targets only get the
+// byte loop.
+//
+//   simd_span_ws     ' ' '\t'
+//   simd_span_ident  A-Z a-z 0-9 _
+//   simd_span_number 0-9 . : - ' '   (what the digit branch collects)
+//
+// simd_find2() is the delimiter search for literals: the first a or b in
+// [p, end), or end. Single delimiters go through memchr(), which libc
+// already vectorizes.
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stddef.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define SIMD_SSE2 1
+#endif
+#if defined(SIMD_SSE2) && (defined(__GNUC__) || defined(__clang__)) && !defined(SIMD_NO_AVX2)
+  #include <immintrin.h>
+  #define SIMD_AVX2 1
+  #define SIMD_AVX2_FN __attribute__((target("avx2")))
+#endif
+
+static inline int simd_is_ws(unsigned char c) {
+    return c == ' ' || c == '\t';
+}
+
+static inline int simd_is_ident(unsigned char c) {
+    return (unsigned char)((c | 0x20) - 'a') < 26 || (unsigned char)(c - '0') < 10 || c == '_';
+}
+
+static inline int simd_is_number(unsigned char c) {
+    return (unsigned char)(c - '-') <= ':' - '-' ? c != '/' : c == ' ';
+}
+
+#ifdef SIMD_SSE2
+/* bytes are compared as signed, so anything >= 0x80 falls outside every range */
+static inline __m128i simd_in_range16(__m128i v, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8((char)(lo - 1))),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8((char)(hi + 1))));
+}
+
+static inline __m128i simd_ws16(__m128i v) {
+    return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+}
+
+static inline __m128i simd_ident16(__m128i v) {
+    __m128i alpha = simd_in_range16(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z');
+    __m128i digit = simd_in_range16(v, '0', '9');
+    return _mm_or_si128(_mm_or_si128(alpha, digit), _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+}
+
+static inline __m128i simd_number16(__m128i v) {
+    __m128i run = _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('/')), simd_in_range16(v, '-', ':'));
+    return _mm_or_si128(run, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+}
+#endif
+
+#ifdef SIMD_AVX2
+static inline SIMD_AVX2_FN __m256i simd_in_range32(__m256i v, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8((char)(lo - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(hi + 1)), v));
+}
+
+static inline SIMD_AVX2_FN __m256i simd_ws32(__m256i v) {
+    return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+}
+
+static inline SIMD_AVX2_FN __m256i simd_ident32(__m256i v) {
+    __m256i alpha = simd_in_range32(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 'z');
+    __m256i digit = simd_in_range32(v, '0', '9');
+    return _mm256_or_si256(_mm256_or_si256(alpha, digit), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+}
+
+static inline SIMD_AVX2_FN __m256i simd_number32(__m256i v) {
+    __m256i run = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')), simd_in_range32(v, '-', ':'));
+    return _mm256_or_si256(run, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+}
+
+static inline int simd_have_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+
+/* One scanner per class. The AVX2 loop lives in its own target("avx2")
+   function; the caller picks it once per call with a predictable branch. */
+#define SIMD_SPAN_FUNCS(name, pred)                                                      \
+    SIMD_SPAN_AVX2(name)                                                                 \
+    static inline const char *simd_span_##name(const char *p, const char *end) {        \
+        SIMD_SPAN_CALL_AVX2(name)                                                        \
+        SIMD_SPAN_LOOP_SSE2(name)                                                        \
+        while (p < end && pred((unsigned char)*p)) p++;                                  \
+        return p;                                                                        \
+    }
+
+#ifdef SIMD_AVX2
+  #define SIMD_SPAN_AVX2(name)                                                           \
+    static SIMD_AVX2_FN const char *simd_span32_##name(const char *p, const char *end) { \
+        while (end - p >= 32) {                                                          \
+            __m256i v = _mm256_loadu_si256((const __m256i *)p);                          \
+            unsigned miss = ~(unsigned)_mm256_movemask_epi8(simd_##name##32(v));         \
+            if (miss) return p + __builtin_ctz(miss);                                    \
+            p += 32;                                                                     \
+        }                                                                                \
+        return p;                                                                        \
+    }
+  #define SIMD_SPAN_CALL_AVX2(name)                                                      \
+        if (end - p >= 32 && simd_have_avx2()) {                                         \
+            p = simd_span32_##name(p, end);                                              \
+            if (end - p >= 32) return p;   /* stopped inside the data */                 \
+        }
+#else
+  #define SIMD_SPAN_AVX2(name)
+  #define SIMD_SPAN_CALL_AVX2(name)
+#endif
+
+#ifdef SIMD_SSE2
+  #if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    static inline unsigned simd_ctz(unsigned x) { unsigned long i; _BitScanForward(&i, x); return (unsigned)i; }
+  #else
+    #define simd_ctz(x) ((unsigned)__builtin_ctz(x))
+  #endif
+  #define SIMD_SPAN_LOOP_SSE2(name)                                                      \
+        while (end - p >= 16) {                                                          \
+            __m128i v = _mm_loadu_si128((const __m128i *)p);                             \
+            unsigned miss = ~(unsigned)_mm_movemask_epi8(simd_##name##16(v)) & 0xFFFFu;  \
+            if (miss) return p + simd_ctz(miss);                                         \
+            p += 16;                                                                     \
+        }
+#else
+  #define SIMD_SPAN_LOOP_SSE2(name)
+#endif
+
+#ifdef SIMD_AVX2
+static SIMD_AVX2_FN const char *simd_find2_avx2(const char *p, const char *end, char a, char b) {
+    __m256i va = _mm256_set1_epi8(a), vb = _mm256_set1_epi8(b);
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)p);
+        unsigned hit = (unsigned)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, va),
+                                                                      _mm256_cmpeq_epi8(v, vb)));
+        if (hit) return p + __builtin_ctz(hit);
+        p += 32;
+    }
+    return p;
+}
+#endif
+
+static inline const char *simd_find2(const char *p, const char *end, char a, char b) {
+#ifdef SIMD_AVX2
+    if (end - p >= 32 && simd_have_avx2()) {
+        p = simd_find2_avx2(p, end, a, b);
+        if (end - p >= 32) return p;
+    }
+#endif
+#ifdef SIMD_SSE2
+    __m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b);
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        unsigned hit = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)));
+        if (hit) return p + simd_ctz(hit);
+        p += 16;
+    }
+#endif
+    while (p < end && *p != a && *p != b) p++;
+    return p;
+}
+
+SIMD_SPAN_FUNCS(ws, simd_is_ws)
+SIMD_SPAN_FUNCS(ident, simd_is_ident)
+SIMD_SPAN_FUNCS(number, simd_is_number)
+
+#endif // SIMD_H
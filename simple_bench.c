@@ -0,0 +1,912 @@
+// simple_bench.c  (build: gcc -O2 -o simple_bench simple_bench.c)
+// Micro-benchmarks for the lexer's hot paths. Each one runs the current
+// code against the implementation it replaced on the same input and
+// prints nanoseconds per item:
+//
+//     ./simple_bench words [FILE]   word classification (wordclass.h vs lookup.h)
+//     ./simple_bench ops [FILE]     operator recognition (lex_ops table vs strcmp chain)
+//     ./simple_bench rows [FILE]    symbol table rows (outbuf.h vs fprintf), in rows/s
+//     ./simple_bench relex [FILE]   one-byte edits: relex() vs lexing the whole file again
+//                                   (each spliced result is checked against the full lex)
+//     ./simple_bench lookup [LEN]   lookup.h vs the goto DFA it replaced, on every string
+//                                   of up to LEN (default 6) letters and blanks and more;
+//                                   exits 1 if they disagree on any input
+//
+// FILE defaults to sample_code.simp; the identifiers, operators or tokens in
+// it are collected once and processed over and over. Rows are written to
+// /dev/null, so only the formatting is measured.
+//
+// The suite measures the current code on large generated corpora instead:
+//
+//     ./simple_bench gen MIX MB [SEED] > corpus.simp
+//     ./simple_bench suite [--mb N] [--seed S] [--json FILE] [MIX...]
+//
+// MIX is mixed, keyword, comment, literal, operator or error (see gen_mixes).
+// For each mix the suite reports the scanner (MB/s, tokens/s), the word
+// classifier (ns/word, with the lookup.h chain for comparison) and the
+// table writer (rows/s, MB/s of output), each with its peak RSS. --json
+// writes the same numbers as one JSON object for comparing runs.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "lexer.h"
+#include "lineindex.h"
+#include "lookup.h"  // lookupKeyword(), last step of the chain classify_word() replaced
+#include "lookup_goto.h"  // lookupKeywordGoto(), the hand-written DFA lookup.h replaced
+#include "outbuf.h"
+#include "relex.h"
+#include "symtab.h"
+
+#define BENCH_MIN_NS 200000000.0   // repeat each measurement for at least 0.2 s
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* ---------- words ---------- */
+
+typedef struct {
+    const char **word;
+    size_t *len;
+    size_t count;
+} WordList;
+
+// identifier-shaped lexemes of the file, in source order
+static int collect_words(Lexer *lx, WordList *wl) {
+    size_t cap = 1024;
+    wl->word = malloc(cap * sizeof(*wl->word));
+    wl->len = malloc(cap * sizeof(*wl->len));
+    wl->count = 0;
+    if (!wl->word || !wl->len) return 0;
+    Token t;
+    while (lexer_next(lx, &t)) {
+        if (t.type != T_IDENTIFIER && t.type != T_KEYWORD && t.type != T_DATATYPE && t.type != T_RESERVED &&
+            t.type != T_NOISE && t.type != T_BOOL)
+            continue;
+        if (t.flags & SYMF_COOKED) continue;   // "to do" spans two words
+        if (wl->count == cap) {
+            cap *= 2;
+            const char **nw = realloc(wl->word, cap * sizeof(*nw));
+            if (nw) wl->word = nw;
+            size_t *nl = realloc(wl->len, cap * sizeof(*nl));
+            if (nl) wl->len = nl;
+            if (!nw || !nl) return 0;
+        }
+        wl->word[wl->count] = lx->src.data + t.off;
+        wl->len[wl->count] = t.len;
+        wl->count++;
+    }
+    return 1;
+}
+
+/* the chain classify_word() replaced: fold into a buffer, two strcasecmp,
+   a linear datatype scan, then lookupKeyword() (which folds again) */
+static SymType classify_word_dfa(const char *word, size_t len) {
+    static const char *types[] = {"int", "float", "char", "string", "text", "secure", "bool", "time", "date",
+                                  "timestamp", "array", "collection", NULL};
+    char low[MAX_LEX];
+    size_t L = len < MAX_LEX ? len : MAX_LEX - 1;
+    for (size_t i = 0; i < L; ++i) low[i] = tolower((unsigned char)word[i]);
+    low[L] = '\0';
+    if (strcasecmp(low, "true") == 0 || strcasecmp(low, "false") == 0) return T_BOOL;
+    for (int i = 0; types[i]; ++i)
+        if (strcmp(low, types[i]) == 0) return T_DATATYPE;
+    switch (lookupKeyword(low)) {
+        case 1: return T_KEYWORD;
+        case 2: return T_RESERVED;
+        case 3: return T_NOISE;
+        default: return T_IDENTIFIER;
+    }
+}
+
+static const SymType bench_word_types[] = {
+    [WC_IDENT] = T_IDENTIFIER, [WC_BOOL] = T_BOOL, [WC_DATATYPE] = T_DATATYPE,
+    [WC_KEYWORD] = T_KEYWORD, [WC_RESERVED] = T_RESERVED, [WC_NOISE] = T_NOISE,
+};
+
+// ns per word; *sum keeps the results live
+static double time_words(const WordList *wl, int hashed, unsigned long *sum) {
+    double start = now_ns(), elapsed;
+    size_t done = 0;
+    do {
+        for (size_t i = 0; i < wl->count; ++i)
+            *sum += hashed ? bench_word_types[classify_word(wl->word[i], wl->len[i])]
+                           : classify_word_dfa(wl->word[i], wl->len[i]);
+        done += wl->count;
+    } while ((elapsed = now_ns() - start) < BENCH_MIN_NS);
+    return elapsed / (double)done;
+}
+
+static int bench_words(const char *path) {
+    Lexer lx;
+    if (!lexer_open(&lx, path)) { fprintf(stderr, "cannot open %s\n", path); return 1; }
+    WordList wl;
+    if (!collect_words(&lx, &wl)) { fprintf(stderr, "out of memory\n"); return 1; }
+    if (wl.count == 0) { fprintf(stderr, "%s has no words\n", path); return 1; }
+
+    for (size_t i = 0; i < wl.count; ++i)
+        if (bench_word_types[classify_word(wl.word[i], wl.len[i])] != classify_word_dfa(wl.word[i], wl.len[i])) {
+            fprintf(stderr, "mismatch on '%.*s'\n", (int)wl.len[i], wl.word[i]);
+            return 1;
+        }
+
+    unsigned long sum = 0;
+    double dfa = time_words(&wl, 0, &sum);
+    double hash = time_words(&wl, 1, &sum);
+    printf("words: %zu from %s\n", wl.count, path);
+    printf("  lookup.h chain   %7.2f ns/word\n", dfa);
+    printf("  classify_word    %7.2f ns/word  (%.1fx)\n", hash, dfa / hash);
+    if (sum == 1) putchar('\n');   // never true; stops the loops being optimised out
+
+    free(wl.word);
+    free(wl.len);
+    lexer_destroy(&lx);
+    return 0;
+}
+
+/* ---------- lookup: lookup.h against the goto DFA it replaced ---------- */
+
+// the words lookupKeywordGoto() spells out, with their multi-word and dead ends
+static const char *lookup_goto_words[] = {
+    "let", "local", "store", "show", "if", "try", "do", "to do", "get", "else", "end", "next", "return",
+    "handle", "global", "int", "float", "char", "string", "text", "secure", "bool", "time", "date",
+    "timestamp", "array", "collection", "system", "for", "error", "null", "object", "main", "to", "then",
+    "please", "true", "false",
+};
+#define LOOKUP_GOTO_WORDS (sizeof(lookup_goto_words) / sizeof(lookup_goto_words[0]))
+
+typedef struct {
+    unsigned long checked, bad;
+} LookupCheck;
+
+static void lookup_check(LookupCheck *lc, const char *s) {
+    int want = lookupKeywordGoto(s), got = lookupKeyword(s);
+    lc->checked++;
+    if (want == got) return;
+    if (lc->bad++ < 10) {
+        fprintf(stderr, "mismatch on \"");
+        for (const char *p = s; *p; ++p)
+            fprintf(stderr, (unsigned char)*p < 0x20 || (unsigned char)*p >= 0x7f ? "\\x%02x" : "%c", (unsigned char)*p);
+        fprintf(stderr, "\": goto %d, lookup.h %d\n", want, got);
+    }
+}
+
+// every string of 1..max bytes from alphabet
+static void lookup_all(LookupCheck *lc, const char *alphabet, char *buf, int depth, int max) {
+    for (const char *a = alphabet; *a; ++a) {
+        buf[depth] = *a;
+        buf[depth + 1] = '\0';
+        lookup_check(lc, buf);
+        if (depth + 1 < max) lookup_all(lc, alphabet, buf, depth + 1, max);
+    }
+}
+
+/* Runs both matchers over the input families the generated header was
+   accepted on, and fails if they disagree on any. Rerun it after
+   regenerating lookup.h: a word added to or dropped from keywords.txt on
+   purpose shows up here as expected mismatches, and nothing else should. */
+static int bench_lookup(int max_len) {
+    LookupCheck all = {0, 0};
+    char buf[64];
+    double start = now_ns();
+
+    // 1. every lowercase string of up to max_len letters and blanks
+    lookup_all(&all, "abcdefghijklmnopqrstuvwxyz ", buf, 0, max_len);
+    printf("  letters and blanks up to %d  %12lu\n", max_len, all.checked);
+
+    // 2. mixed case over the letters the words are made of
+    unsigned long n = all.checked;
+    lookup_all(&all, "tToOdD eEnNsSlLiIaArRmMcC", buf, 0, max_len - 1);
+    printf("  mixed case up to %d          %12lu\n", max_len - 1, all.checked - n);
+
+    /* 3. each word and each of its prefixes, lower and upper case, with every
+       byte appended and every byte in place of each letter */
+    n = all.checked;
+    for (size_t w = 0; w < LOOKUP_GOTO_WORDS; ++w) {
+        size_t len = strlen(lookup_goto_words[w]);
+        for (size_t plen = 1; plen <= len; ++plen)
+            for (int upper = 0; upper < 2; ++upper) {
+                for (size_t i = 0; i < plen; ++i)
+                    buf[i] = upper ? (char)toupper((unsigned char)lookup_goto_words[w][i]) : lookup_goto_words[w][i];
+                buf[plen] = '\0';
+                lookup_check(&all, buf);
+                for (int c = 1; c < 256; ++c) {
+                    buf[plen] = (char)c;
+                    buf[plen + 1] = '\0';
+                    lookup_check(&all, buf);
+                }
+                buf[plen] = '\0';
+                for (size_t i = 0; i < plen; ++i) {
+                    char keep = buf[i];
+                    for (int c = 1; c < 256; ++c) {
+                        buf[i] = (char)c;
+                        lookup_check(&all, buf);
+                    }
+                    buf[i] = keep;
+                }
+            }
+    }
+    printf("  word edits                  %12lu\n", all.checked - n);
+
+    // 4. random strings with digits, '_' and high bytes as well
+    static const char extra[] = "0123456789_ \x80\xc3\xa9\xff";
+    uint64_t rng = 88172645463325252ull;
+    n = all.checked;
+    for (int k = 0; k < 2000000; ++k) {
+        rng ^= rng >> 12;
+        rng ^= rng << 25;
+        rng ^= rng >> 27;
+        uint64_t r = rng * 0x2545F4914F6CDD1Dull;
+        int len = 1 + (int)(r % 12);
+        for (int i = 0; i < len; ++i) {
+            r = r * 6364136223846793005ull + 1442695040888963407ull;
+            unsigned pick = (unsigned)(r >> 33) % (26 + 26 + sizeof(extra) - 1);
+            buf[i] = pick < 26 ? (char)('a' + pick) : pick < 52 ? (char)('A' + pick - 26) : extra[pick - 52];
+        }
+        buf[len] = '\0';
+        lookup_check(&all, buf);
+    }
+    printf("  random                      %12lu\n", all.checked - n);
+
+    printf("lookup: %lu inputs in %.1f s, %lu mismatches\n", all.checked, (now_ns() - start) / 1e9, all.bad);
+    return all.bad ? 1 : 0;
+}
+
+/* ---------- ops ---------- */
+
+typedef struct {
+    int *c, *nxt;   // first byte of each operator and the byte after it (EOF at the end)
+    size_t count;
+} OpList;
+
+static int is_operator_type(SymType t) {
+    return t >= T_UNARY_OP && t <= T_RBRACKET && t != T_LBRACKET;
+}
+
+static int collect_ops(Lexer *lx, OpList *ol) {
+    size_t cap = 1024;
+    ol->c = malloc(cap * sizeof(*ol->c));
+    ol->nxt = malloc(cap * sizeof(*ol->nxt));
+    ol->count = 0;
+    if (!ol->c || !ol->nxt) return 0;
+    Token t;
+    while (lexer_next(lx, &t)) {
+        if (!is_operator_type(t.type) || lx->src.data[t.off] == '/') continue;   // '/' belongs to the comment scanner
+        if (ol->count == cap) {
+            cap *= 2;
+            int *nc = realloc(ol->c, cap * sizeof(*nc));
+            if (nc) ol->c = nc;
+            int *nn = realloc(ol->nxt, cap * sizeof(*nn));
+            if (nn) ol->nxt = nn;
+            if (!nc || !nn) return 0;
+        }
+        ol->c[ol->count] = (unsigned char)lx->src.data[t.off];
+        ol->nxt[ol->count] = t.off + 1 < lx->src.len ? (unsigned char)lx->src.data[t.off + 1] : EOF;
+        ol->count++;
+    }
+    return 1;
+}
+
+/* the chain lex_match_operator() replaced: build twobuf, then up to 14 strcmp */
+static SymType match_operator_strcmp(int c, int nxt, size_t *len, bool *sign) {
+    char twobuf[3] = {0};
+    if (nxt != EOF) {
+        twobuf[0] = (char)c;
+        twobuf[1] = (char)nxt;
+    }
+    *len = 2;
+    *sign = false;
+    if (strcmp(twobuf, "++") == 0 || strcmp(twobuf, "--") == 0) return T_UNARY_OP;
+    *len = 1;
+    if (c == '^') return T_EXP_OP;
+    *len = 2;
+    if (strcmp(twobuf, "<=") == 0 || strcmp(twobuf, ">=") == 0 ||
+        strcmp(twobuf, "==") == 0 || strcmp(twobuf, "!=") == 0) return T_REL_OP;
+    if (strcmp(twobuf, "+=") == 0 || strcmp(twobuf, "-=") == 0 ||
+        strcmp(twobuf, "*=") == 0 || strcmp(twobuf, "/=") == 0 ||
+        strcmp(twobuf, "%=") == 0 || strcmp(twobuf, "~=") == 0) return T_ASSIGN_OP;
+    *len = 1;
+    if (c == '=') return T_ASSIGN_OP;
+    if (c == '<' || c == '>') return T_REL_OP;
+    *len = 2;
+    if (strcmp(twobuf, "&&") == 0 || strcmp(twobuf, "||") == 0) return T_LOGICAL_OP;
+    *len = 1;
+    if (c == '!') return T_LOGICAL_OP;
+    if (c == '*' || c == '%' || c == '~' || c == '/') return T_ARITH_OP;
+    if (c == '+' || c == '-') { *sign = true; return T_ARITH_OP; }
+    if (c == ':') return T_COLON;
+    if (c == ',') return T_COMMA;
+    if (c == '(') return T_LPAREN;
+    if (c == ')') return T_RPAREN;
+    if (c == ']') return T_RBRACKET;
+    return T_LEX_ERROR;
+}
+
+static double time_ops(const OpList *ol, int table, unsigned long *sum) {
+    double start = now_ns(), elapsed;
+    size_t done = 0, len;
+    bool sign;
+    do {
+        for (size_t i = 0; i < ol->count; ++i)
+            *sum += (table ? lex_match_operator(ol->c[i], ol->nxt[i], &len, &sign)
+                           : match_operator_strcmp(ol->c[i], ol->nxt[i], &len, &sign)) + len + sign;
+        done += ol->count;
+    } while ((elapsed = now_ns() - start) < BENCH_MIN_NS);
+    return elapsed / (double)done;
+}
+
+static int bench_ops(const char *path) {
+    Lexer lx;
+    if (!lexer_open(&lx, path)) { fprintf(stderr, "cannot open %s\n", path); return 1; }
+    OpList ol;
+    if (!collect_ops(&lx, &ol)) { fprintf(stderr, "out of memory\n"); return 1; }
+    if (ol.count == 0) { fprintf(stderr, "%s has no operators\n", path); return 1; }
+
+    for (size_t i = 0; i < ol.count; ++i) {
+        size_t l1, l2;
+        bool s1, s2;
+        if (lex_match_operator(ol.c[i], ol.nxt[i], &l1, &s1) != match_operator_strcmp(ol.c[i], ol.nxt[i], &l2, &s2) ||
+            l1 != l2 || s1 != s2) {
+            fprintf(stderr, "mismatch on '%c' followed by %d\n", ol.c[i], ol.nxt[i]);
+            return 1;
+        }
+    }
+
+    unsigned long sum = 0;
+    double chain = time_ops(&ol, 0, &sum);
+    double table = time_ops(&ol, 1, &sum);
+    printf("ops: %zu from %s\n", ol.count, path);
+    printf("  strcmp chain     %7.2f ns/op\n", chain);
+    printf("  lex_ops table    %7.2f ns/op  (%.1fx)\n", table, chain / table);
+    if (sum == 1) putchar('\n');
+
+    free(ol.c);
+    free(ol.nxt);
+    lexer_destroy(&lx);
+    return 0;
+}
+
+/* ---------- rows ---------- */
+
+static const char *row_token_name(SymType t) {
+    return t < T_COUNT ? token_names[t] : "UNKNOWN";
+}
+
+// rows per second for writing every row of tab, line index included; 0 if
+// /dev/null cannot be opened. With outbuf.h, *bytes (if not NULL) gets the
+// size of one pass.
+static double time_rows(Lexer *lx, const SymTable *tab, int buffered, unsigned long long *bytes) {
+    double start = now_ns(), elapsed;
+    size_t done = 0;
+    do {
+        OutBuf ob;
+        FILE *f = NULL;
+        LineIndex lines;
+        if (!li_build(&lines, lx->src.data, lx->src.len)) return 0;
+        if (buffered ? !ob_open(&ob, "/dev/null") : !(f = fopen("/dev/null", "w"))) { li_free(&lines); return 0; }
+        for (size_t i = 0; i < tab->count; ++i) {
+            SymType t = (SymType)tab->type[i];
+            size_t ln;
+            unsigned line, col;
+            const char *lex = lexer_lexeme(lx, tab->off[i], tab->len[i], t, tab->flags[i], &ln);
+            li_position(&lines, lexer_token_start(tab->off[i], tab->flags[i]), &line, &col);
+            if (buffered) {
+                const char *tok = row_token_name(t);
+                ob_uint(&ob, line, 6);
+                ob_lit(&ob, " | ");
+                ob_uint(&ob, col, 6);
+                ob_lit(&ob, " | ");
+                ob_str_pad(&ob, tok, strlen(tok), 15);
+                ob_lit(&ob, " | ");
+                ob_bytes(&ob, lex, ln);
+                ob_putc(&ob, '\n');
+            } else {
+                fprintf(f, "%6u | %6u | %-15s | %.*s\n", line, col, row_token_name(t), (int)ln, lex);
+            }
+        }
+        if (buffered) {
+            ob_flush(&ob);
+            if (bytes) *bytes = ob.written;
+            ob_close(&ob);
+        } else {
+            fclose(f);
+        }
+        li_free(&lines);
+        done += tab->count;
+    } while ((elapsed = now_ns() - start) < BENCH_MIN_NS);
+    return (double)done / (elapsed / 1e9);
+}
+
+static int bench_rows(const char *path) {
+    Lexer lx;
+    if (!lexer_open(&lx, path)) { fprintf(stderr, "cannot open %s\n", path); return 1; }
+    SymTable tab;
+    if (!symtab_init(&tab, lx.src.len)) { fprintf(stderr, "out of memory\n"); return 1; }
+    Token t;
+    while (lexer_next(&lx, &t))
+        if (!symtab_push(&tab, (uint8_t)t.type, (uint8_t)t.flags, (uint32_t)t.off, (uint32_t)t.len, 0)) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+    if (tab.count == 0) { fprintf(stderr, "%s has no tokens\n", path); return 1; }
+
+    double old = time_rows(&lx, &tab, 0, NULL);
+    double ob = time_rows(&lx, &tab, 1, NULL);
+    if (old == 0 || ob == 0) { fprintf(stderr, "cannot open /dev/null\n"); return 1; }
+    printf("rows: %zu from %s\n", tab.count, path);
+    printf("  fprintf          %7.2f M rows/s\n", old / 1e6);
+    printf("  outbuf.h         %7.2f M rows/s  (%.1fx)\n", ob / 1e6, ob / old);
+
+    symtab_free(&tab);
+    lexer_destroy(&lx);
+    return 0;
+}
+
+/* ---------- relex ---------- */
+
+#define RELEX_EDITS 64
+
+static int lex_all(const char *src, size_t len, SymTable *tab) {
+    Lexer lx;
+    lexer_init(&lx, src, len);
+    if (!symtab_init(tab, len)) return 0;
+    Token t;
+    while (lexer_next(&lx, &t))
+        if (!symtab_push(tab, (uint8_t)t.type, (uint8_t)t.flags, (uint32_t)t.off, (uint32_t)t.len,
+                         t.type == T_LEX_ERROR) ||
+            ((t.flags & SYMF_VALUE) && !symtab_push_value(tab, t.value)))
+            return 0;
+    return 1;
+}
+
+// same tokens, errors and values
+static int relex_same(const SymTable *a, const SymTable *b) {
+    if (a->count != b->count || a->errcount != b->errcount || a->valcount != b->valcount) return 0;
+    for (size_t i = 0; i < a->count; ++i)
+        if (a->type[i] != b->type[i] || a->flags[i] != b->flags[i] || a->off[i] != b->off[i] || a->len[i] != b->len[i])
+            return 0;
+    return (!a->errcount || memcmp(a->errs, b->errs, a->errcount * sizeof(*a->errs)) == 0) &&
+           (!a->valcount || (memcmp(a->vidx, b->vidx, a->valcount * sizeof(*a->vidx)) == 0 &&
+                             memcmp(a->vals, b->vals, a->valcount * sizeof(*a->vals)) == 0));
+}
+
+static int bench_relex(const char *path) {
+    Lexer lx;
+    if (!lexer_open(&lx, path)) { fprintf(stderr, "cannot open %s\n", path); return 1; }
+    const char *src = lx.src.data;
+    size_t len = lx.src.len;
+    SymTable tab;
+    if (!lex_all(src, len, &tab)) { fprintf(stderr, "out of memory\n"); return 1; }
+
+    /* each edit types one 'x' into the original file at a spread-out offset */
+    RelexEdit edits[RELEX_EDITS];
+    char *srcs[RELEX_EDITS];
+    size_t lens[RELEX_EDITS];
+    for (int i = 0; i < RELEX_EDITS; ++i) {
+        edits[i] = (RelexEdit){(size_t)((unsigned long long)len * (2 * i + 1) / (2 * RELEX_EDITS)), 0, "x", 1};
+        if (!(srcs[i] = relex_apply_edit(src, len, &edits[i], &lens[i]))) { fprintf(stderr, "out of memory\n"); return 1; }
+    }
+
+    /* relex() and relex_splice() must give each edited file the table a full
+       lex of it gives, before either is timed */
+    int ok = 1;
+    for (int i = 0; i < RELEX_EDITS && ok; ++i) {
+        SymTable spliced = {0}, full = {0};
+        RelexResult r = {0};
+        if (!lex_all(src, len, &spliced) || relex(&spliced, srcs[i], lens[i], &edits[i], &r) ||
+            !relex_splice(&spliced, &r) || !lex_all(srcs[i], lens[i], &full)) {
+            fprintf(stderr, "out of memory\n");
+            ok = 0;
+        } else if (!relex_same(&spliced, &full)) {
+            fprintf(stderr, "mismatch after the edit at offset %zu\n", edits[i].off);
+            ok = 0;
+        }
+        relex_free(&r);
+        symtab_free(&spliced);
+        symtab_free(&full);
+    }
+    if (!ok) {
+        for (int i = 0; i < RELEX_EDITS; ++i) free(srcs[i]);
+        symtab_free(&tab);
+        lexer_destroy(&lx);
+        return 1;
+    }
+
+    size_t fresh = 0, done = 0;
+    double start = now_ns(), relex_ns;
+    do {
+        for (int i = 0; i < RELEX_EDITS; ++i) {
+            RelexResult r;
+            if (relex(&tab, srcs[i], lens[i], &edits[i], &r)) { fprintf(stderr, "out of memory\n"); return 1; }
+            fresh += r.fresh.count;
+            relex_free(&r);
+        }
+        done += RELEX_EDITS;
+    } while ((relex_ns = now_ns() - start) < BENCH_MIN_NS);
+    relex_ns /= (double)done;
+    double avg_fresh = (double)fresh / (double)done;
+
+    done = 0;
+    double full_ns;
+    start = now_ns();
+    do {
+        SymTable t;
+        if (!lex_all(srcs[done % RELEX_EDITS], lens[done % RELEX_EDITS], &t)) { fprintf(stderr, "out of memory\n"); return 1; }
+        symtab_free(&t);
+        done++;
+    } while ((full_ns = now_ns() - start) < BENCH_MIN_NS);
+    full_ns /= (double)done;
+
+    printf("relex: %zu tokens in %s, %d edits\n", tab.count, path, RELEX_EDITS);
+    printf("  full lex         %10.2f us/edit\n", full_ns / 1e3);
+    printf("  relex()          %10.2f us/edit  (%.0fx, %.1f tokens re-lexed)\n", relex_ns / 1e3, full_ns / relex_ns,
+           avg_fresh);
+
+    for (int i = 0; i < RELEX_EDITS; ++i) free(srcs[i]);
+    symtab_free(&tab);
+    lexer_destroy(&lx);
+    return 0;
+}
+
+/* ---------- gen: synthetic corpora ---------- */
+
+enum { GEN_KEYWORD, GEN_COMMENT, GEN_LITERAL, GEN_OPERATOR, GEN_ERROR, GEN_KINDS };
+
+// relative weights of the statement kinds
+typedef struct {
+    const char *name;
+    unsigned weight[GEN_KINDS];
+} GenMix;
+
+static const GenMix gen_mixes[] = {
+    {"mixed",    {35, 15, 25, 20,  5}},
+    {"keyword",  {75,  5,  5, 10,  5}},
+    {"comment",  {15, 70,  5,  5,  5}},
+    {"literal",  {10,  5, 70, 10,  5}},
+    {"operator", {10,  5,  5, 75,  5}},
+    {"error",    {20,  5, 10, 15, 50}},
+};
+#define GEN_MIXES (sizeof(gen_mixes) / sizeof(gen_mixes[0]))
+
+static const char *gen_words[] = {
+    "counter", "total", "price", "name", "score", "grade", "value", "result", "index", "userInput",
+    "tempValue", "isActive", "logTime", "items", "x", "y", "i", "j", "a", "b",
+};
+
+typedef struct {
+    char *buf;
+    size_t len, cap;
+    uint64_t rng;
+    char names[8][32];   // gen_name() rotates through these
+    unsigned next_name;
+} Gen;
+
+static uint64_t gen_rand(Gen *g) {   // xorshift64*
+    g->rng ^= g->rng >> 12;
+    g->rng ^= g->rng << 25;
+    g->rng ^= g->rng >> 27;
+    return g->rng * 0x2545F4914F6CDD1Dull;
+}
+
+static unsigned gen_pick(Gen *g, unsigned n) {
+    return (unsigned)((gen_rand(g) >> 32) % n);
+}
+
+static const char *gen_name(Gen *g) {
+    char *n = g->names[g->next_name++ % 8];
+    const char *w = gen_words[gen_pick(g, sizeof(gen_words) / sizeof(gen_words[0]))];
+    if (gen_pick(g, 3) == 0) snprintf(n, sizeof(g->names[0]), "%s%u", w, gen_pick(g, 100));
+    else snprintf(n, sizeof(g->names[0]), "%s", w);
+    return n;
+}
+
+static int gen_printf(Gen *g, const char *fmt, ...) {
+    for (;;) {
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(g->buf + g->len, g->cap - g->len, fmt, ap);
+        va_end(ap);
+        if (n < 0) return 0;
+        if ((size_t)n < g->cap - g->len) {
+            g->len += (size_t)n;
+            return 1;
+        }
+        char *nb = realloc(g->buf, g->cap * 2);
+        if (!nb) return 0;
+        g->buf = nb;
+        g->cap *= 2;
+    }
+}
+
+#define N gen_name(g)
+#define U(k) gen_pick(g, k)
+
+static int gen_statement(Gen *g, int kind) {
+    const char *in = gen_pick(g, 2) ? "    " : "";
+    switch (kind) {
+    case GEN_KEYWORD:
+        switch (U(9)) {
+        case 0: return gen_printf(g, "%sif %s >= %u then\n%s    show \"It is %s\"\n%send if\n", in, N, U(100), in, N, in);
+        case 1: return gen_printf(g, "%slet %s = %s\n", in, N, N);
+        case 2: return gen_printf(g, "%sstore %s = %u\n", in, N, U(1000));
+        case 3: return gen_printf(g, "%sget %s\n%sshow \"You entered: \" + %s\n", in, N, in, N);
+        case 4: return gen_printf(g, "to do %s(a, b)\n    return a + b\nend\n", N);
+        case 5: return gen_printf(g, "try\n    %s = %s / %u\nhandle\n    show error\nend\n", N, N, U(10));
+        case 6: return gen_printf(g, "%sfor i = 0 to %u\n%s    next\n%send\n", in, U(50), in, in);
+        case 7: return gen_printf(g, "object main\n    local %s = null\nend;\n", N);
+        default: return gen_printf(g, "%selse if %s == true then\n%s    show %s\n", in, N, in, N);
+        }
+    case GEN_COMMENT:
+        switch (U(3)) {
+        case 0: return gen_printf(g, "%s// %s is updated here before it is shown\n", in, N);
+        case 1: return gen_printf(g, "/* %s:\n   computed once, reused by every caller\n   see the notes above */\n", N);
+        default: return gen_printf(g, "%s%s = %u   // trailing note on %s\n", in, N, U(1000), N);
+        }
+    case GEN_LITERAL:
+        switch (U(12)) {
+        case 0: return gen_printf(g, "%sint %s = %u\n", in, N, U(100000));
+        case 1: return gen_printf(g, "%sfloat %s = %u.%u\n", in, N, U(1000), U(1000));
+        case 2: return gen_printf(g, "%sdate %s = 20%02u-%02u-%02u\n", in, N, U(100), 1 + U(12), 1 + U(28));
+        case 3: return gen_printf(g, "%stimestamp %s = 20%02u-%02u-%02u %02u:%02u:%02u\n", in, N, U(100), 1 + U(12),
+                                  1 + U(28), U(24), U(60), U(60));
+        case 4: return gen_printf(g, "%stime %s = %02u:%02u:%02u\n", in, N, U(24), U(60), U(60));
+        case 5: return gen_printf(g, "%sstring %s = \"Hello %s\"\n", in, N, N);
+        case 6: return gen_printf(g, "%schar %s = '%c'\n", in, N, 'A' + U(26));
+        case 7: return gen_printf(g, "%sarray %s = [%u, %u, %u, %u]\n", in, N, U(100), U(100), U(100), U(100));
+        case 8: return gen_printf(g, "%scollection %s = {\"alpha\", \"beta\", \"%s\"}\n", in, N, N);
+        case 9: return gen_printf(g, "text %s = \"\"\"\nA TEXT literal over\ntwo lines with \"\"quotes\"\"\n\"\"\"\n", N);
+        case 10: return gen_printf(g, "%ssecure %s = `Key%u`\n", in, N, U(10000));
+        default: return gen_printf(g, "%sbool %s = %s\n", in, N, U(2) ? "true" : "false");
+        }
+    case GEN_OPERATOR:
+        switch (U(6)) {
+        case 0: return gen_printf(g, "%s%s = %s + %s * %s - %u / %s %% 2\n", in, N, N, N, N, U(100), N);
+        case 1: return gen_printf(g, "%s%s += %u\n%s%s -= %s\n", in, N, U(10), in, N, N);
+        case 2: return gen_printf(g, "%sif %s <= %s && %s != %s || !%s then\n", in, N, N, N, N, N);
+        case 3: return gen_printf(g, "%s++%s\n%s--%s\n", in, N, in, N);
+        case 4: return gen_printf(g, "%s%s = -%s ^ 2\n", in, N, N);
+        default: return gen_printf(g, "%s%s = (%s, %s) ~ %s\n", in, N, N, N, N);
+        }
+    default:
+        switch (U(5)) {
+        case 0: return gen_printf(g, "%s%s = %s @ %s\n", in, N, N, N);
+        case 1: return gen_printf(g, "%s%s# = %u\n", in, N, U(100));
+        case 2: return gen_printf(g, "%sshow $%s & %s | %s\n", in, N, N, N);
+        case 3: return gen_printf(g, "%s%s = 'ab'\n", in, N);
+        default: return gen_printf(g, "%s%s = 12.5.3 ? %s\n", in, N, N);
+        }
+    }
+}
+
+#undef N
+#undef U
+
+static const GenMix *gen_find_mix(const char *name) {
+    for (size_t i = 0; i < GEN_MIXES; ++i)
+        if (strcmp(gen_mixes[i].name, name) == 0) return &gen_mixes[i];
+    return NULL;
+}
+
+// a corpus of at least bytes bytes; NULL when out of memory
+static char *gen_corpus(const GenMix *mix, size_t bytes, uint64_t seed, size_t *len) {
+    Gen g = {0};
+    g.cap = bytes + 4096;
+    g.buf = malloc(g.cap);
+    g.rng = seed * 0x9E3779B97F4A7C15ull + 1;
+    if (!g.buf) return NULL;
+    unsigned total = 0;
+    for (int k = 0; k < GEN_KINDS; ++k) total += mix->weight[k];
+    while (g.len < bytes) {
+        unsigned r = gen_pick(&g, total);
+        int kind = 0;
+        while (r >= mix->weight[kind]) r -= mix->weight[kind++];
+        if (!gen_statement(&g, kind) || (gen_pick(&g, 8) == 0 && !gen_printf(&g, "\n"))) {
+            free(g.buf);
+            return NULL;
+        }
+    }
+    *len = g.len;
+    return g.buf;
+}
+
+static int bench_gen(int argc, char **argv) {
+    const GenMix *mix = argc > 2 ? gen_find_mix(argv[2]) : NULL;
+    double mb = argc > 3 ? atof(argv[3]) : 0;
+    if (!mix || mb <= 0) { fprintf(stderr, "usage: %s gen MIX MB [SEED]\n", argv[0]); return 2; }
+    size_t len;
+    char *corpus = gen_corpus(mix, (size_t)(mb * 1048576), argc > 4 ? strtoull(argv[4], NULL, 10) : 1, &len);
+    if (!corpus) { fprintf(stderr, "out of memory\n"); return 1; }
+    int ok = fwrite(corpus, 1, len, stdout) == len;
+    free(corpus);
+    return ok ? 0 : 1;
+}
+
+/* ---------- suite ---------- */
+
+/* peak resident set size of this process in kB. On Linux the peak can be
+   reset to the current size, which gives each stage its own figure. */
+static void rss_reset_peak(void) {
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+    if (f) {
+        fputs("5", f);
+        fclose(f);
+    }
+}
+
+static long rss_peak_kb(void) {
+    FILE *f = fopen("/proc/self/status", "r");
+    if (f) {
+        char line[128];
+        long kb = -1;
+        while (fgets(line, sizeof(line), f))
+            if (sscanf(line, "VmHWM: %ld kB", &kb) == 1) break;
+        fclose(f);
+        if (kb >= 0) return kb;
+    }
+    struct rusage ru;
+    return getrusage(RUSAGE_SELF, &ru) == 0 ? ru.ru_maxrss : -1;
+}
+
+typedef struct {
+    const char *mix;
+    size_t bytes, tokens, words;
+    double scan_mb_s, scan_tok_s;
+    double classify_ns, lookup_ns;
+    double write_rows_s, write_mb_s;
+    long scan_rss, classify_rss, write_rss;
+} SuiteResult;
+
+static int suite_run(const GenMix *mix, size_t bytes, uint64_t seed, SuiteResult *r) {
+    memset(r, 0, sizeof(*r));
+    r->mix = mix->name;
+    char *src = gen_corpus(mix, bytes, seed, &r->bytes);
+    if (!src) return 0;
+
+    /* scanner: lexer_next() over the whole corpus */
+    rss_reset_peak();
+    size_t passes = 0;
+    double start = now_ns(), elapsed;
+    do {
+        Lexer lx;
+        Token t;
+        lexer_init(&lx, src, r->bytes);
+        r->tokens = 0;
+        while (lexer_next(&lx, &t)) r->tokens++;
+        lexer_destroy(&lx);
+        passes++;
+    } while ((elapsed = now_ns() - start) < BENCH_MIN_NS);
+    r->scan_mb_s = (double)r->bytes * passes / 1048576.0 / (elapsed / 1e9);
+    r->scan_tok_s = (double)r->tokens * passes / (elapsed / 1e9);
+    r->scan_rss = rss_peak_kb();
+
+    /* classifier: every identifier-shaped lexeme */
+    rss_reset_peak();
+    Lexer lx;
+    lexer_init(&lx, src, r->bytes);
+    WordList wl;
+    int ok = collect_words(&lx, &wl);   // the lists are set even when it fails
+    r->words = wl.count;
+    if (ok && wl.count) {
+        unsigned long sum = 0;
+        r->classify_ns = time_words(&wl, 1, &sum);
+        r->lookup_ns = time_words(&wl, 0, &sum);
+        if (sum == 1) putchar('\n');
+    }
+    free(wl.word);
+    free(wl.len);
+    lexer_destroy(&lx);
+    if (!ok) {
+        free(src);
+        return 0;
+    }
+    r->classify_rss = rss_peak_kb();
+
+    /* writer: the table as simple_lex writes it, into /dev/null */
+    rss_reset_peak();
+    SymTable tab;
+    if (!lex_all(src, r->bytes, &tab)) {
+        symtab_free(&tab);
+        free(src);
+        return 0;
+    }
+    lexer_init(&lx, src, r->bytes);
+    unsigned long long out_bytes = 0;
+    r->write_rows_s = time_rows(&lx, &tab, 1, &out_bytes);
+    r->write_mb_s = r->write_rows_s * ((double)out_bytes / (double)tab.count) / 1048576.0;
+    lexer_destroy(&lx);
+    symtab_free(&tab);
+    r->write_rss = rss_peak_kb();
+
+    free(src);
+    return 1;
+}
+
+static void suite_print(const SuiteResult *r) {
+    printf("%s: %.1f MB, %zu tokens, %zu words\n", r->mix, (double)r->bytes / 1048576.0, r->tokens, r->words);
+    printf("  scanner     %8.1f MB/s   %8.2f M tokens/s   peak RSS %6.1f MB\n", r->scan_mb_s, r->scan_tok_s / 1e6,
+           r->scan_rss / 1024.0);
+    printf("  classifier  %8.2f ns/word (lookup.h chain %.2f)  peak RSS %6.1f MB\n", r->classify_ns, r->lookup_ns,
+           r->classify_rss / 1024.0);
+    printf("  writer      %8.1f MB/s   %8.2f M rows/s     peak RSS %6.1f MB\n", r->write_mb_s, r->write_rows_s / 1e6,
+           r->write_rss / 1024.0);
+}
+
+static int suite_write_json(const char *path, const SuiteResult *res, size_t n, double mb, uint64_t seed) {
+    FILE *f = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!f) return 0;
+    fprintf(f, "{\"lexer_version\":%d,\"mb\":%g,\"seed\":%llu,\"results\":[", LEXER_VERSION, mb,
+            (unsigned long long)seed);
+    for (size_t i = 0; i < n; ++i) {
+        const SuiteResult *r = &res[i];
+        fprintf(f, "%s\n{\"mix\":\"%s\",\"bytes\":%zu,\"tokens\":%zu,\"words\":%zu,", i ? "," : "", r->mix,
+                r->bytes, r->tokens, r->words);
+        fprintf(f, "\"scanner\":{\"mb_s\":%.2f,\"tokens_s\":%.0f,\"peak_rss_kb\":%ld},", r->scan_mb_s,
+                r->scan_tok_s, r->scan_rss);
+        fprintf(f, "\"classifier\":{\"ns_per_word\":%.3f,\"lookup_h_ns_per_word\":%.3f,\"peak_rss_kb\":%ld},",
+                r->classify_ns, r->lookup_ns, r->classify_rss);
+        fprintf(f, "\"writer\":{\"mb_s\":%.2f,\"rows_s\":%.0f,\"peak_rss_kb\":%ld}}", r->write_mb_s,
+                r->write_rows_s, r->write_rss);
+    }
+    fprintf(f, "\n]}\n");
+    return f == stdout ? fflush(f) == 0 : fclose(f) == 0;
+}
+
+static int bench_suite(int argc, char **argv) {
+    double mb = 16;
+    uint64_t seed = 1;
+    const char *json = NULL;
+    const GenMix *mixes[GEN_MIXES];
+    size_t nmix = 0;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--mb") == 0 && i + 1 < argc) mb = atof(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) json = argv[++i];
+        else if (nmix < GEN_MIXES && (mixes[nmix] = gen_find_mix(argv[i])) != NULL) nmix++;
+        else { fprintf(stderr, "unknown mix or option: %s\n", argv[i]); return 2; }
+    }
+    if (mb <= 0) { fprintf(stderr, "--mb must be positive\n"); return 2; }
+    if (nmix == 0)
+        for (; nmix < GEN_MIXES; ++nmix) mixes[nmix] = &gen_mixes[nmix];
+
+    SuiteResult res[GEN_MIXES];
+    for (size_t i = 0; i < nmix; ++i) {
+        if (!suite_run(mixes[i], (size_t)(mb * 1048576), seed, &res[i])) { fprintf(stderr, "out of memory\n"); return 1; }
+        if (!json || strcmp(json, "-") != 0) suite_print(&res[i]);
+    }
+    if (json && !suite_write_json(json, res, nmix, mb, seed)) { fprintf(stderr, "cannot write %s\n", json); return 1; }
+    return 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s words|ops|rows|relex [FILE]\n", prog);
+    fprintf(stderr, "       %s lookup [LEN]\n", prog);
+    fprintf(stderr, "       %s gen MIX MB [SEED]\n", prog);
+    fprintf(stderr, "       %s suite [--mb N] [--seed S] [--json FILE] [MIX...]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) { usage(argv[0]); return 2; }
+    if (strcmp(argv[1], "lookup") == 0) {
+        int max_len = argc > 2 ? atoi(argv[2]) : 6;
+        if (max_len < 2 || max_len > 16) { fprintf(stderr, "LEN must be 2 to 16\n"); return 2; }
+        return bench_lookup(max_len);
+    }
+    if (strcmp(argv[1], "gen") == 0) return bench_gen(argc, argv);
+    if (strcmp(argv[1], "suite") == 0) return bench_suite(argc, argv);
+    const char *file = argc > 2 ? argv[2] : "sample_code.simp";
+    if (strcmp(argv[1], "words") == 0) return bench_words(file);
+    if (strcmp(argv[1], "ops") == 0) return bench_ops(file);
+    if (strcmp(argv[1], "rows") == 0) return bench_rows(file);
+    if (strcmp(argv[1], "relex") == 0) return bench_relex(file);
+    usage(argv[0]);
+    return 2;
+}
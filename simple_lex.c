@@ -1,4 +1,4 @@
-// simple_lex.c 
+// simple_lex.c  (build: gcc -O2 -pthread -o simple_lex simple_lex.c)
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -8,7 +8,10 @@
 
 #ifdef _WIN32
   #include <direct.h>
+  #include <process.h>
   #define getcwd _getcwd
+  #define getpid _getpid
+  #define lstat stat   /* no symlinks to follow */
   #define PATH_SEP '\\'
 #else
   #include <unistd.h>
@@ -20,119 +23,53 @@
   #define PATH_MAX 1024
 #endif
 
-#include "lookup.h"  // user-provided DFA keyword matcher - must exist
-
-#define MAX_LEX 4096
-#define MAX_SYMBOLS 40000
-#define MAX_ERRORS 4096
-
-typedef enum {
-    T_NEWLINE, T_WHITESPACE, T_COMMENT,
-    T_STRING, T_TEXT, T_SECURE, T_CHAR,
-    T_FLOAT, T_INT, T_BOOL, T_TIME, T_DATE, T_TIMESTAMP,
-    T_ARRAY, T_COLLECTION,
-    T_DATATYPE, T_KEYWORD, T_RESERVED, T_NOISE, T_IDENTIFIER,
-    T_UNARY_OP, T_EXP_OP, T_ASSIGN_OP, T_REL_OP, T_LOGICAL_OP, T_ARITH_OP,
-    T_COLON, T_COMMA, T_LPAREN, T_RPAREN, T_LBRACKET, T_RBRACKET,
-    T_LEX_ERROR, T_UNKNOWN,
-    T_COUNT
-} SymType;
-
-typedef struct {
-    char lex[MAX_LEX];
-    SymType type;
-    int line;
-    int col;
-} Symbol;
-
-static Symbol symtab[MAX_SYMBOLS];
-static int symcount = 0;
-
-/* error record for summary */
-typedef struct {
-    char lex[MAX_LEX];
-    int line;
-    int col;
-} LexError;
-static LexError errors[MAX_ERRORS];
-static int errcount = 0;
-
-/* (for unary detection) */
-static SymType prev_type = T_NEWLINE; // start-of-input acts like newline -> allows unary at start
-static char prev_lexeme[128] = "";
-
-static void update_prev_token(const char *lex, SymType type) {
-    prev_type = type;
-    if (lex && lex[0]) {
-        strncpy(prev_lexeme, lex, sizeof(prev_lexeme) - 1);
-        prev_lexeme[sizeof(prev_lexeme)-1] = '\0';
-    } else {
-        prev_lexeme[0] = '\0';
-    }
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "lexer.h"   // reentrant scanner (pulls in wordclass.h and source.h)
+#include "symtab.h"  // growable column-wise token table
+#include "lineindex.h" // line/column of a byte offset, for printing positions
+#include "pool.h"    // work-stealing thread pool for --batch
+#include "parlex.h"  // split-and-reconcile lexing of one file on several threads
+#include "outbuf.h"  // large-buffer writer with hand-rolled number formatting
+#include "tokbin.h"  // --binary token stream format and its reader
+#include "tokcache.h" // --cache: token records keyed by a hash of the source
+#include "trivia.h"  // --fold-trivia: whitespace/newlines/comments kept as ranges, not rows
+#include "nested.h"  // --elements: tokens inside ARRAY and COLLECTION literals
+
+static bool fold_trivia = false;    /* --fold-trivia */
+static bool show_elements = false;  /* --elements */
+
+/* Pieces of SymbolTable.txt, shared by the buffered table writer and the
+   streaming sink so both produce the same file. */
+static void write_table_header(OutBuf *f) {
+    ob_lit(f, "=== SIMPLE LEXICAL ANALYZER OUTPUT ===\n\n");
+    ob_lit(f, "------------- SYMBOL TABLE -------------\n");
+    ob_lit(f, " Line |   Col | Token           | Lexeme\n");
+    ob_lit(f, "-------------------------------------------------------\n");
 }
 
-static void add_symbol(const char *lex, SymType type, int line, int col) {
-    if (!lex) return;
-    if (symcount < MAX_SYMBOLS) {
-        strncpy(symtab[symcount].lex, lex, MAX_LEX - 1);
-        symtab[symcount].lex[MAX_LEX - 1] = '\0';
-        symtab[symcount].type = type;
-        symtab[symcount].line = line;
-        symtab[symcount].col = col;
-        ++symcount;
-    }
-    if (type == T_LEX_ERROR) {
-        if (errcount < MAX_ERRORS) {
-            strncpy(errors[errcount].lex, lex, MAX_LEX - 1);
-            errors[errcount].lex[MAX_LEX - 1] = '\0';
-            errors[errcount].line = line;
-            errors[errcount].col = col;
-            ++errcount;
-        }
-    }
-    /* Update prev token only for meaningful tokens — don't let whitespace/newline/comment overwrite context */
-    if (type != T_WHITESPACE && type != T_NEWLINE && type != T_COMMENT) {
-        update_prev_token(lex, type);
-    }
+/* "%6u | %6u | %-15s | %.*s\n", without going through printf */
+static void write_row_named(OutBuf *f, const char *tok, size_t tn, unsigned line, unsigned col, const char *lx, size_t ln) {
+    ob_uint(f, line, 6);
+    ob_lit(f, " | ");
+    ob_uint(f, col, 6);
+    ob_lit(f, " | ");
+    ob_str_pad(f, tok, tn, 15);
+    ob_lit(f, " | ");
+    ob_bytes(f, lx, ln);
+    ob_putc(f, '\n');
 }
 
-/* mapping from SymType to name used in symbol table & summary */
-static const char *token_names[T_COUNT] = {
-    "NEWLINE", "WHITESPACE", "COMMENT",
-    "STRING", "TEXT", "SECURE", "CHAR",
-    "FLOAT", "INT", "BOOL", "TIME", "DATE", "TIMESTAMP",
-    "ARRAY", "COLLECTION",
-    "DATATYPE", "KEYWORD", "RESERVED", "NOISE", "IDENTIFIER",
-    "UNARY_OP", "EXP_OP", "ASSIGN_OP", "REL_OP", "LOGICAL_OP", "ARITH_OP",
-    "COLON", "COMMA", "LPAREN", "RPAREN", "LBRACKET", "RBRACKET",
-    "LEXICAL_ERROR", "UNKNOWN"
-};
-
-/* write symbol table */
-static int write_symbol_table_to_path(const char *outpath) {
-    FILE *f = fopen(outpath, "w");
-    if (!f) return 0;
-
-    fprintf(f, "=== SIMPLE LEXICAL ANALYZER OUTPUT ===\n\n");
-    fprintf(f, "------------- SYMBOL TABLE -------------\n");
-    fprintf(f, " Line |   Col | Token           | Lexeme\n");
-    fprintf(f, "-------------------------------------------------------\n");
-
-    for (int i = 0; i < symcount; ++i) {
-        const char *tok;
-        SymType t = symtab[i].type;
-        if (t >= 0 && t < T_COUNT) tok = token_names[t];
-        else tok = "UNKNOWN";
-
-        fprintf(f, "%6d | %6d | %-15s | %s\n",
-                symtab[i].line, symtab[i].col, tok, symtab[i].lex);
-    }
-
-    long counts[T_COUNT];
-    for (int i = 0; i < T_COUNT; ++i) counts[i] = 0;
-    for (int i = 0; i < symcount; ++i) counts[symtab[i].type]++;
+static void write_symbol_row(OutBuf *f, SymType t, unsigned line, unsigned col, const char *lx, size_t ln) {
+    const char *tok;
+    if (t < T_COUNT) tok = token_names[t];
+    else tok = "UNKNOWN";
+    write_row_named(f, tok, strlen(tok), line, col, lx, ln);
+}
 
-    fprintf(f, "\n--- Token Summary ---\n");
+static void write_token_summary(OutBuf *f, const long counts[T_COUNT], long total_incl) {
+    ob_lit(f, "\n--- Token Summary ---\n");
 
     /* Print the most important tokens (selective) */
     const SymType order[] = {
@@ -159,667 +96,716 @@ static int write_symbol_table_to_path(const char *outpath) {
     const int order_len = sizeof(order)/sizeof(order[0]);
 
     for (int i = 0; i < order_len; ++i)
-        fprintf(f, "%-12s: %ld\n", token_names[ order[i] ], counts[ order[i] ]);
+        ob_printf(f, "%-12s: %ld\n", token_names[ order[i] ], counts[ order[i] ]);
 
-    long total_incl = symcount;
     long total_excl = total_incl - counts[T_WHITESPACE] - counts[T_NEWLINE];
 
-    fprintf(f, "\nTotal tokens (including whitespace/newlines): %ld\n", total_incl);
-    fprintf(f, "Total tokens (excluding whitespace/newlines): %ld\n\n", total_excl);
-
-    fprintf(f, "Errors (%d):\n", errcount);
-    if (errcount == 0) fprintf(f, "  (none)\n");
-    else {
-        for (int i = 0; i < errcount; ++i)
-            fprintf(f, "  - Invalid token '%s' at line %d, col %d\n",
-                    errors[i].lex, errors[i].line, errors[i].col);
-    }
+    ob_printf(f, "\nTotal tokens (including whitespace/newlines): %ld\n", total_incl);
+    ob_printf(f, "Total tokens (excluding whitespace/newlines): %ld\n\n", total_excl);
+}
 
-    fclose(f);
-    return 1;
+static void write_error_row(OutBuf *f, const char *lx, size_t ln, unsigned line, unsigned col) {
+    ob_lit(f, "  - Invalid token '");
+    ob_bytes(f, lx, ln);
+    ob_printf(f, "' at line %u, col %u\n", line, col);
 }
 
-/* scanning state */
-static FILE *infile = NULL;
-static int cur_line = 1;
-static int cur_col  = 0;
-
-static int getch(void) {
-    int c = fgetc(infile);
-    if (c == EOF) return EOF;
-    if (c == '\n') {
-        cur_line++;
-        cur_col = 0;
-    } else {
-        cur_col++;
+/* --json: JSON Lines instead of the table, one object per token and a final
+   summary object. Lexemes are the source text (a newline is "\n" itself, not
+   the two characters the table prints), escaped by ob_json_str(). Literals
+   with a parsed value (numlit.h) carry it as "value". With --fold-trivia a
+   row carries the trivia before it, if any, as "trivia". */
+static void write_json_row(OutBuf *f, SymType t, unsigned line, unsigned col, const char *lx, size_t ln,
+                           const LitValue *val, const char *triv, size_t tn) {
+    const char *tok = t < T_COUNT ? token_names[t] : "UNKNOWN";
+    ob_lit(f, "{\"type\":\"");
+    ob_write(f, tok, strlen(tok));
+    ob_lit(f, "\",\"lexeme\":");
+    ob_json_str(f, lx, ln);
+    ob_lit(f, ",\"line\":");
+    ob_uint(f, line, 0);
+    ob_lit(f, ",\"col\":");
+    ob_uint(f, col, 0);
+    if (val && t == T_FLOAT) {
+        /* the shortest of %.15g / %.17g that reads back as the same double */
+        char num[32];
+        snprintf(num, sizeof(num), "%.15g", val->f);
+        if (strtod(num, NULL) != val->f) snprintf(num, sizeof(num), "%.17g", val->f);
+        ob_lit(f, ",\"value\":");
+        ob_write(f, num, strlen(num));
+    } else if (val) {
+        ob_lit(f, ",\"value\":");
+        if (val->i >= 0 && (uint64_t)val->i <= ULONG_MAX) ob_uint(f, (unsigned long)val->i, 0);
+        else ob_printf(f, "%lld", (long long)val->i);   // dates before 1970, or wider than a long
     }
-    return c;
+    if (tn) {
+        ob_lit(f, ",\"trivia\":");
+        ob_json_str(f, triv, tn);
+    }
+    ob_lit(f, "}\n");
 }
 
-static void ungetch(int c) {
-    if (c == EOF) return;
-    if (ungetc(c, infile) == EOF) return;
-    if (c == '\n') {
-        if (cur_line > 1) cur_line--;
-        cur_col = 0;
-    } else {
-        if (cur_col > 0) cur_col--;
+// the summary object up to the opening of its error list; trailing trivia (--fold-trivia) if tn > 0
+static void write_json_summary_head(OutBuf *f, const long counts[T_COUNT], long total_incl,
+                                    const char *triv, size_t tn) {
+    ob_lit(f, "{\"summary\":{\"counts\":{");
+    for (int t = 0; t < T_COUNT; ++t)
+        ob_printf(f, "%s\"%s\":%ld", t ? "," : "", token_names[t], counts[t]);
+    ob_printf(f, "},\"total\":%ld,\"total_excluding_whitespace\":%ld,",
+              total_incl, total_incl - counts[T_WHITESPACE] - counts[T_NEWLINE]);
+    if (tn) {
+        ob_lit(f, "\"trailing_trivia\":");
+        ob_json_str(f, triv, tn);
+        ob_putc(f, ',');
     }
+    ob_lit(f, "\"errors\":[");
 }
 
-static int peekch(void) {
-    int c = getch();
-    if (c == EOF) return EOF;
-    ungetch(c);
-    return c;
+static void write_json_error(OutBuf *f, bool first, const char *lx, size_t ln, unsigned line, unsigned col) {
+    if (!first) ob_putc(f, ',');
+    ob_lit(f, "{\"lexeme\":");
+    ob_json_str(f, lx, ln);
+    ob_printf(f, ",\"line\":%u,\"col\":%u}", line, col);
 }
 
-/* Known datatypes as keywords for declarations (still recognized separately as DATATYPE token) */
-static bool is_datatype(const char *s) {
-    const char *types[] = {"int", "float", "char", "string", "text", "secure", "bool", "time", "date", "timestamp", "array", "collection", NULL};
-    for (int i = 0; types[i]; ++i)
-        if (strcmp(s, types[i]) == 0)
-            return true;
-    return false;
+static const char *json_lexeme(Lexer *lex, size_t off, size_t len, SymType t, unsigned flags, size_t *ln) {
+    if (t == T_NEWLINE) { *ln = len; return lex->src.data + off; }
+    return lexer_lexeme(lex, off, len, t, flags, ln);
 }
 
-/* Helper: decide whether previous token context allows a unary + or - */
-static bool prev_allows_unary(void) {
-    switch (prev_type) {
-        case T_NEWLINE:
-        case T_ASSIGN_OP:
-        case T_ARITH_OP:
-        case T_REL_OP:
-        case T_LOGICAL_OP:
-        case T_UNARY_OP:
-        case T_COLON:
-        case T_COMMA:
-        case T_LPAREN:
-        case T_LBRACKET:
-            return true;
-        default:
-            break;
-    }
-    if (prev_lexeme[0] == '\0') return true;
-    return false;
-}
+/* --stream: rows go to the output as they are produced, summary counts are
+   kept on the fly and only the (small) error records are held until EOF */
+typedef struct {
+    size_t off;
+    unsigned len;
+    unsigned char flags;
+    unsigned long line;     /* resolved when recorded: the cursor only moves forward */
+    unsigned long col;
+} LexError;
 
-/* Helper: check if string is "true" or "false" (case-insensitive) */
-static bool is_bool_literal(const char *s) {
-    if (!s) return false;
-    if (strcasecmp(s, "true") == 0) return true;
-    if (strcasecmp(s, "false") == 0) return true;
-    return false;
-}
+static OutBuf stream_out;
+static bool stream_json = false;    /* --json rows instead of table rows */
+static LineCursor stream_lines;
+static TriviaFold stream_fold;      /* --fold-trivia */
+static long stream_counts[T_COUNT];
+static long stream_total = 0;
+static LexError *stream_errs = NULL;
+static size_t stream_errcount = 0, stream_errcap = 0;
+static size_t stream_released = 0;   /* source bytes already handed back to the OS */
+
+#define STREAM_RELEASE_STEP ((size_t)64 << 20)
+
+static void stream_symbol(Lexer *lex, const Token *t) {
+    size_t ln, start = lexer_token_start(t->off, t->flags), lead = start;
+    unsigned long line, col;
+    stream_counts[t->type]++;
+    stream_total++;
+    if (fold_trivia && !fold_token(&stream_fold, t->type, start, &lead)) return;
+
+    lc_position(&stream_lines, start, &line, &col);
+    if (stream_json) {
+        const char *lx = json_lexeme(lex, t->off, t->len, t->type, t->flags, &ln);
+        write_json_row(&stream_out, t->type, (unsigned)line, (unsigned)col, lx, ln,
+                       (t->flags & SYMF_VALUE) ? &t->value : NULL, lex->src.data + lead, start - lead);
+    } else {
+        const char *lx = lexer_lexeme(lex, t->off, t->len, t->type, t->flags, &ln);
+        write_symbol_row(&stream_out, t->type, (unsigned)line, (unsigned)col, lx, ln);
+    }
 
-/* helpers to validate date/time patterns minimally */
-static bool looks_like_time(const char *s) {
-    // Accept HH:MM or HH:MM:SS (basic)
-    int n = strlen(s);
-    if (n < 4) return false;
-    int colon_count = 0;
-    for (int i = 0; i < n; ++i) if (s[i] == ':') colon_count++;
-    return (colon_count == 1 || colon_count == 2);
-}
-static bool looks_like_date_iso(const char *s) {
-    // Very basic ISO-like YYYY-MM-DD (digits and '-' at positions)
-    int n = strlen(s);
-    if (n < 8) return false;
-    int dash_count = 0;
-    for (int i = 0; i < n; ++i) if (s[i] == '-') dash_count++;
-    return dash_count == 2;
-}
+    if (t->type == T_LEX_ERROR) {
+        if (stream_errcount == stream_errcap) {
+            size_t ncap = stream_errcap ? stream_errcap * 2 : 64;
+            LexError *ne = realloc(stream_errs, ncap * sizeof(*ne));
+            if (!ne) { fprintf(stderr, "Out of memory after %zu errors\n", stream_errcount); exit(1); }
+            stream_errs = ne;
+            stream_errcap = ncap;
+        }
+        LexError *e = &stream_errs[stream_errcount++];
+        e->off = t->off;
+        e->len = (unsigned)t->len;
+        e->flags = (unsigned char)t->flags;
+        e->line = line;
+        e->col = col;
+    }
 
-/* Read until matching quote/delimiter with basic escape handling.
-   Returns dynamically allocated string (caller must free) containing inner content (without outer quotes/brackets).
-   If not closed properly, returns NULL.
-*/
-static char *read_until(FILE *f, int *out_line, int *out_col, int delim, int allow_escape) {
-    (void)f; // unused but kept for signature consistency
-    return NULL;
+    /* keep the resident part of a mapped input bounded */
+    if (t->off >= stream_released + STREAM_RELEASE_STEP) {
+        src_release_before(&lex->src, t->off);
+        stream_released = t->off;
+    }
 }
 
-int main(void) {
-    char filename[PATH_MAX];
-    printf("\n === SIMPLE Lexical Analyzer ===\n\n");
-    printf("Enter SIMPLE source file: ");
-    if (!fgets(filename, sizeof(filename), stdin)) return 1;
-
-    filename[strcspn(filename, "\r\n")] = 0;
-
-    infile = fopen(filename, "r");
-    if (!infile) { perror("Cannot open file\nOnly .simp file extension will be read"); return 1; }
+static void write_stream_tail(Lexer *lex, OutBuf *f) {
+    if (stream_json) {
+        size_t tail = fold_trivia ? fold_tail(&stream_fold, lex->src.len) : lex->src.len;
+        write_json_summary_head(f, stream_counts, stream_total, lex->src.data + tail, lex->src.len - tail);
+    } else {
+        write_token_summary(f, stream_counts, stream_total);
+        ob_printf(f, "Errors (%zu):\n", stream_errcount);
+        if (stream_errcount == 0) ob_lit(f, "  (none)\n");
+    }
 
-    cur_line = 1;
-    cur_col  = 0;
-    symcount = 0;
-    errcount = 0;
-    prev_type = T_NEWLINE;
-    prev_lexeme[0] = '\0';
+    size_t released = 0;
+    for (size_t i = 0; i < stream_errcount; ++i) {
+        size_t ln;
+        const char *lx = lexer_lexeme(lex, stream_errs[i].off, stream_errs[i].len, T_LEX_ERROR, stream_errs[i].flags, &ln);
+        if (stream_json)
+            write_json_error(f, i == 0, lx, ln, (unsigned)stream_errs[i].line, (unsigned)stream_errs[i].col);
+        else
+            write_error_row(f, lx, ln, (unsigned)stream_errs[i].line, (unsigned)stream_errs[i].col);
+        /* error lexemes fault their pages back in; drop them again as we go */
+        if (stream_errs[i].off >= released + STREAM_RELEASE_STEP) {
+            src_release_before(&lex->src, stream_errs[i].off);
+            released = stream_errs[i].off;
+        }
+    }
+    if (stream_json) ob_lit(f, "]}}\n");
+}
 
-    int c;
-    while ((c = getch()) != EOF) {
+/* lex the whole input into a table, folding the trivia away as it comes if
+   fold is set; returns NULL or a reason for failing */
+static const char *lex_into_table(Lexer *lex, SymTable *tab, bool fold) {
+    if (lex->src.len > UINT32_MAX) return "input is larger than 4 GB; use --stream";
+    /* about half the tokens are trivia; size a folded table for the rest */
+    if (!symtab_init(tab, fold ? lex->src.len / 2 : lex->src.len) || (fold && !symtab_enable_lead(tab)))
+        return "out of memory";
+
+    Token t;
+    if (!fold) {
+        while (lexer_next(lex, &t)) {
+            if (!symtab_push(tab, (uint8_t)t.type, (uint8_t)t.flags, (uint32_t)t.off, (uint32_t)t.len,
+                             t.type == T_LEX_ERROR) ||
+                ((t.flags & SYMF_VALUE) && !symtab_push_value(tab, t.value)))
+                return "out of memory";
+        }
+        return NULL;
+    }
 
-        /* NEWLINE */
-        if (c == '\n') {
-            add_symbol("\\n", T_NEWLINE, cur_line - 1, 1);
+    TriviaFold f;
+    size_t lead;
+    fold_init(&f);
+    while (lexer_next(lex, &t)) {
+        if (!fold_token(&f, t.type, lexer_token_start(t.off, t.flags), &lead)) {
+            tab->folded[t.type]++;
             continue;
         }
+        if (!symtab_push_lead(tab, (uint8_t)t.type, (uint8_t)t.flags, (uint32_t)t.off, (uint32_t)t.len, (uint32_t)lead) ||
+            ((t.flags & SYMF_VALUE) && !symtab_push_value(tab, t.value)))
+            return "out of memory";
+    }
+    tab->tail = (uint32_t)fold_tail(&f, lex->src.len);
+    return NULL;
+}
 
-        /* WHITESPACE */
-        if (c == ' ' || c == '\t') {
-            int start_col_ws = cur_col;
-            char buf[256]; int bi = 0;
-            buf[bi++] = (char)c;
+/* per-type counts for the Token Summary, folded trivia included; returns the total */
+static long count_token_types(const SymTable *tab, long counts[T_COUNT]) {
+    /* summary pass only touches the type column */
+    for (int i = 0; i < T_COUNT; ++i) counts[i] = 0;
+    for (size_t i = 0; i < tab->count; ++i) counts[tab->type[i]]++;
+    long total = (long)tab->count;
+    for (int i = 0; i < 3; ++i) {
+        counts[i] += (long)tab->folded[i];
+        total += (long)tab->folded[i];
+    }
+    return total;
+}
 
-            int ch;
-            while ((ch = getch()) != EOF && (ch == ' ' || ch == '\t')) {
-                if (bi < 255) buf[bi++] = (char)ch;
-            }
-            if (ch != EOF) ungetch(ch);
+/* write symbol table */
+#define ELEMENTS_MAX_DEPTH 16   // deeper literals are listed as their span only
+
+/* --elements: the element tokens of an ARRAY or COLLECTION, right after its
+   row, with the token name indented two spaces per level. They are lexed
+   here, on demand, and are not part of the summary or the error list. */
+static void write_element_rows(OutBuf *f, Lexer *lex, LineIndex *lines, NestedCache *nc,
+                               SymType type, size_t off, size_t len, int depth) {
+    const SymTable *el = depth <= ELEMENTS_MAX_DEPTH ? nested_elements(nc, type, off, len) : NULL;
+    if (!el) return;
+    char name[2 * ELEMENTS_MAX_DEPTH + 16];
+    unsigned line, col;
+    for (size_t k = 0; k < el->count; ++k) {
+        SymType t = (SymType)el->type[k];
+        if (fold_trivia && trivia_is(t)) continue;
+        size_t ln;
+        const char *lx = lexer_lexeme(lex, el->off[k], el->len[k], t, el->flags[k], &ln);
+        li_position(lines, lexer_token_start(el->off[k], el->flags[k]), &line, &col);
+        int nn = snprintf(name, sizeof(name), "%*s%s", 2 * depth, "", token_names[t]);
+        write_row_named(f, name, (size_t)nn, line, col, lx, ln);
+        write_element_rows(f, lex, lines, nc, t, el->off[k], el->len[k], depth + 1);
+    }
+}
 
-            buf[bi] = '\0';
+static int write_symbol_table_to_path(Lexer *lex, const SymTable *tab, const char *outpath) {
+    LineIndex lines;
+    if (!li_build(&lines, lex->src.data, lex->src.len)) return 0;
+    OutBuf out, *f = &out;
+    if (!ob_open(f, outpath)) { li_free(&lines); return 0; }
+
+    write_table_header(f);
+
+    NestedCache nc;
+    nested_init(&nc, lex->src.data, lex->src.len);
+    unsigned line, col;
+    for (size_t i = 0; i < tab->count; ++i) {
+        SymType t = (SymType)tab->type[i];
+        size_t ln;
+        const char *lx = lexer_lexeme(lex, tab->off[i], tab->len[i], t, tab->flags[i], &ln);
+        li_position(&lines, lexer_token_start(tab->off[i], tab->flags[i]), &line, &col);
+        write_symbol_row(f, t, line, col, lx, ln);
+        if (show_elements && (t == T_ARRAY || t == T_COLLECTION)) {
+            write_element_rows(f, lex, &lines, &nc, t, tab->off[i], tab->len[i], 1);
+            nested_clear(&nc);   // each literal is listed once; keep memory to one at a time
+        }
+    }
+    nested_free(&nc);
 
-            int start = start_col_ws - ((int)strlen(buf) - 1);
-            if (start < 1) start = 1;
+    long counts[T_COUNT];
+    write_token_summary(f, counts, count_token_types(tab, counts));
 
-            add_symbol(buf, T_WHITESPACE, cur_line, start);
-            continue;
+    ob_printf(f, "Errors (%zu):\n", tab->errcount);
+    if (tab->errcount == 0) ob_lit(f, "  (none)\n");
+    else {
+        for (size_t e = 0; e < tab->errcount; ++e) {
+            uint32_t i = tab->errs[e];
+            size_t ln;
+            const char *lx = lexer_lexeme(lex, tab->off[i], tab->len[i], T_LEX_ERROR, tab->flags[i], &ln);
+            li_position(&lines, lexer_token_start(tab->off[i], tab->flags[i]), &line, &col);
+            write_error_row(f, lx, ln, line, col);
         }
+    }
 
-        int start_line = cur_line;
-        int start_col  = cur_col;
-
-        /* COMMENTS and special handling for '/=' etc */
-        if (c == '/') {
-            int nxt = getch();
-            if (nxt == '/') {
-                char buf[2048]; int bi = 0;
-                buf[bi++] = '/'; buf[bi++] = '/';
-                int ch;
-                while ((ch = getch()) != EOF && ch != '\n') {
-                    if (bi < 2047) buf[bi++] = (char)ch;
-                }
-                buf[bi] = '\0';
-                add_symbol(buf, T_COMMENT, start_line, start_col);
-                if (ch == '\n') continue;
-                continue;
-            }
-            else if (nxt == '*') {
-                char buf[8192]; int bi = 0;
-                buf[bi++] = '/'; buf[bi++] = '*';
-                int ch;
-                int prev = 0;
-                int closed = 0;
-                while ((ch = getch()) != EOF) {
-                    if (bi < 8191) buf[bi++] = (char)ch;
-                    if (prev == '*' && ch == '/') { closed = 1; break; }
-                    prev = ch;
-                }
-                buf[bi] = '\0';
-                if (!closed) add_symbol(buf, T_LEX_ERROR, start_line, start_col);
-                else add_symbol(buf, T_COMMENT, start_line, start_col);
-                continue;
-            }
-            else if (nxt == '=') {
-                /* handle "/=" assignment */
-                add_symbol("/=", T_ASSIGN_OP, start_line, start_col);
-                continue;
-            }
-            else {
-                if (nxt != EOF) ungetch(nxt);
-                add_symbol("/", T_ARITH_OP, start_line, start_col);
-                continue;
-            }
-        }
+    li_free(&lines);
+    return ob_close(f);
+}
 
-        /* TRIPLE-QUOTED TEXT (""" ... """) */
-        if (c == '"' ) {
-            int p1 = peekch();
-            int p2 = EOF;
-            if (p1 != EOF) {
-                getch(); // consume p1
-                p2 = peekch();
-                ungetch(p1); // restore p1
-            }
-            if (p1 == '"' && p2 == '"') {
-                // consume two extra quotes
-                getch(); getch(); // now we've consumed three quotes total (first c and the two)
-                // read until triple quote
-                char buf[MAX_LEX]; int bi = 0;
-                int closed = 0;
-                int ch;
-                while ((ch = getch()) != EOF) {
-                    if (ch == '"' ) {
-                        int q1 = peekch();
-                        if (q1 == '"') {
-                            getch();
-                            int q2 = peekch();
-                            if (q2 == '"') {
-                                getch();
-                                closed = 1;
-                                break;
-                            } else {
-                                // uncommon case: only two quotes, put them back and continue
-                                ungetch(q2);
-                                ungetch('"');
-                                continue;
-                            }
-                        } else {
-                            // a single quote inside text; accept
-                            if (bi < MAX_LEX - 1) buf[bi++] = (char)ch;
-                        }
-                    } else {
-                        if (bi < MAX_LEX - 1) buf[bi++] = (char)ch;
-                    }
-                }
-                buf[bi] = '\0';
-                if (!closed) add_symbol(buf, T_LEX_ERROR, start_line, start_col);
-                else add_symbol(buf, T_TEXT, start_line, start_col);
-                continue;
-            }
-        }
+/* --binary: the table as a tokbin.h token stream */
+static int write_token_binary_to_path(Lexer *lex, const SymTable *tab, const char *outpath) {
+    OutBuf out;
+    if (!ob_open(&out, outpath)) return 0;
+    int ok = tokbin_write(&out, tab, lex->src.data, lex->src.len, token_names, T_COUNT);
+    return ob_close(&out) && ok;
+}
 
-        /* STRING LITERAL "..." (single-line preferred) */
-        if (c == '"') {
-            char buf[MAX_LEX];
-            int bi = 0;
-            int closed = 0;
-            int ch;
-            while ((ch = getch()) != EOF) {
-                if (ch == '\\') {
-                    int e = getch();
-                    if (e == EOF) break;
-                    // store escaped char as-is (we store inner content)
-                    if (bi < MAX_LEX - 2) { buf[bi++] = '\\'; buf[bi++] = (char)e; }
-                    continue;
-                }
-                if (ch == '"') { closed = 1; break; }
-                if (bi < MAX_LEX - 1) buf[bi++] = (char)ch;
-            }
-            buf[bi] = '\0';
-            if (!closed) add_symbol(buf, T_LEX_ERROR, start_line, start_col);
-            else add_symbol(buf, T_STRING, start_line, start_col);
-            continue;
-        }
+/* --from-binary: rebuild the table from a token stream so it can be printed
+   as text. Types are matched by dictionary name, not by number. Returns NULL
+   or a reason for failing; lex is set up over the stream's string section. */
+static const char *load_token_binary(TokBin *tb, Lexer *lex, SymTable *tab) {
+    if (tb->str_len > UINT32_MAX || tb->ntokens > UINT32_MAX) return "token file is too large";
+    uint8_t remap[256];
+    for (uint32_t d = 0; d < tb->ntypes; ++d) {
+        remap[d] = T_UNKNOWN;
+        for (int t = 0; t < T_COUNT; ++t)
+            if (strlen(token_names[t]) == tb->type_len[d] && memcmp(token_names[t], tb->type_name[d], tb->type_len[d]) == 0)
+                remap[d] = (uint8_t)t;
+    }
 
-        /* SECURE literal: backtick-delimited with NO SPACES inside */
-        if (c == '`') {
-            char buf[MAX_LEX];
-            int bi = 0;
-            int ch;
-            int closed = 0;
-            bool has_space = false;
-            while ((ch = getch()) != EOF) {
-                if (ch == '`') { closed = 1; break; }
-                if (isspace(ch)) has_space = true;
-                if (bi < MAX_LEX - 1) buf[bi++] = (char)ch;
-            }
-            buf[bi] = '\0';
-            if (!closed || has_space) add_symbol(buf, T_LEX_ERROR, start_line, start_col);
-            else add_symbol(buf, T_SECURE, start_line, start_col);
-            continue;
-        }
+    lexer_init(lex, tb->str, (size_t)tb->str_len);
+    if (!symtab_init(tab, 0) || !symtab_reserve(tab, (size_t)tb->ntokens)) return "out of memory";
+    TokBinIter it;
+    TokBinToken t;
+    int r;
+    tokbin_iter_init(&it, tb);
+    while ((r = tokbin_next(&it, &t)) > 0) {
+        uint8_t type = remap[t.type];
+        if (!symtab_push(tab, type, t.flags, (uint32_t)t.off, (uint32_t)t.len, type == T_LEX_ERROR) ||
+            ((t.flags & TOKBIN_VALUE) && !symtab_push_value(tab, t.value)))
+            return "out of memory";
+    }
+    return r < 0 ? "token file is corrupt" : NULL;
+}
 
-        /* CHAR literal: 'A' (we will return lexeme as A without quotes) */
-        if (c == '\'') {
-            char buf[8];
-            int bi = 0;
-            int ch = getch();
-            if (ch == EOF) { add_symbol("", T_LEX_ERROR, start_line, start_col); continue; }
-            if (ch == '\\') {
-                int esc = getch();
-                if (esc == EOF) { add_symbol("", T_LEX_ERROR, start_line, start_col); continue; }
-                // accept escaped single char like '\n', '\'', '\\'
-                if (bi < (int)sizeof(buf)-1) buf[bi++] = (char)ch, buf[bi++] = (char)esc;
-                ch = getch(); // should be closing ''
-                if (ch != '\'') { add_symbol("", T_LEX_ERROR, start_line, start_col); continue; }
-                buf[bi] = '\0';
-                add_symbol(buf, T_CHAR, start_line, start_col);
-                continue;
-            } else {
-                // single character then expect closing '\''
-                int closing = getch();
-                if (closing != '\'') {
-                    add_symbol("", T_LEX_ERROR, start_line, start_col);
-                    continue;
-                } else {
-                    char out[4] = {0};
-                    out[0] = (char)ch;
-                    out[1] = '\0';
-                    add_symbol(out, T_CHAR, start_line, start_col);
-                    continue;
-                }
-            }
-        }
+/* ---------- --batch: many files on a thread pool ---------- */
 
-        /* BRACKET / ARRAY handling: decide whether ARRAY literal or LBRACKET delimiter */
-        if (c == '[') {
-            /* Peek ahead skipping spaces/tabs to inspect next non-space character */
-            int look;
-            char saved[256]; int si = 0;
-            while ((look = peekch()) != EOF && (look == ' ' || look == '\t')) {
-                getch();
-                if (si < 255) saved[si++] = (char)look;
-            }
-            int next_non_ws = peekch();
-            /* restore consumed whitespace */
-            for (int i = si - 1; i >= 0; --i) ungetch(saved[i]);
-
-            /* Heuristic: treat as ARRAY literal when next non-space char is one typical of literals
-               or if it's a closing ']' (empty array) */
-            if (next_non_ws == ']' || isdigit(next_non_ws) || next_non_ws == '"' || next_non_ws == '\'' ||
-                next_non_ws == '`' || next_non_ws == '{' || next_non_ws == '[' || next_non_ws == '-' ) {
-
-                /* Emit LBRACKET token first so brackets are visible in symbol table */
-                add_symbol("[", T_LBRACKET, start_line, start_col);
-
-                char buf[MAX_LEX]; int bi = 0;
-                int depth = 1;
-                int ch;
-                bool closed = false;
-                while ((ch = getch()) != EOF) {
-                    if (ch == '[') { depth++; if (bi < MAX_LEX-1) buf[bi++] = (char)ch; }
-                    else if (ch == ']') {
-                        depth--;
-                        if (depth == 0) { closed = true; break; }
-                        else if (bi < MAX_LEX-1) buf[bi++] = (char)ch;
-                    }
-                    else {
-                        if (bi < MAX_LEX-1) buf[bi++] = (char)ch;
-                    }
-                }
-                buf[bi] = '\0';
-                if (!closed) {
-                    add_symbol(buf, T_LEX_ERROR, start_line, start_col);
-                } else {
-                    /* add ARRAY inner content as a token (for analysis) */
-                    if (buf[0] != '\0') add_symbol(buf, T_ARRAY, start_line, start_col + 1);
-                    else add_symbol("", T_ARRAY, start_line, start_col + 1);
-                    /* Emit RBRACKET token at current position */
-                    add_symbol("]", T_RBRACKET, cur_line, cur_col);
-                }
-                continue;
-            } else {
-                /* Treat it as simple LBRACKET delimiter */
-                add_symbol("[", T_LBRACKET, start_line, start_col);
-                continue;
-            }
-        }
+typedef struct {
+    char *path;
+    long long size;
+    char outpath[PATH_MAX + 32];
+    long counts[T_COUNT];
+    long total;
+    const char *failure;    /* NULL when the file was lexed and written */
+    bool cache_hit;         /* --cache: tokens came from the cache ... */
+    bool cache_stored;      /* ... or were lexed and written to it */
+    uint64_t cache_name;    /* the hash its entry is named after, 0 if not opened */
+} BatchFile;
 
-        /* COLLECTIONS: { ... } => COLLECTION (inner content as lexeme) */
-        if (c == '{') {
-            char buf[MAX_LEX];
-            int bi = 0;
-            int depth = 1;
-            int ch;
-            bool closed = false;
-            while ((ch = getch()) != EOF) {
-                if (ch == '{') { depth++; if (bi < MAX_LEX-1) buf[bi++] = (char)ch; }
-                else if (ch == '}') { depth--; if (depth == 0) { closed = true; break; } else if (bi < MAX_LEX-1) buf[bi++] = (char)ch; }
-                else {
-                    if (bi < MAX_LEX-1) buf[bi++] = (char)ch;
-                }
-            }
-            buf[bi] = '\0';
-            if (!closed) add_symbol(buf, T_LEX_ERROR, start_line, start_col);
-            else add_symbol(buf, T_COLLECTION, start_line, start_col);
-            continue;
-        }
+typedef struct {
+    BatchFile *files;
+    size_t count, cap;
+} BatchList;
+
+static int batch_add(BatchList *bl, const char *path, long long size) {
+    if (bl->count == bl->cap) {
+        size_t ncap = bl->cap ? bl->cap * 2 : 64;
+        BatchFile *nf = realloc(bl->files, ncap * sizeof(*nf));
+        if (!nf) return 0;
+        bl->files = nf;
+        bl->cap = ncap;
+    }
+    BatchFile *bf = &bl->files[bl->count];
+    memset(bf, 0, sizeof(*bf));
+    bf->path = strdup(path);
+    if (!bf->path) return 0;
+    bf->size = size;
+    bl->count++;
+    return 1;
+}
 
-        /* If starts with digit => could be INT, FLOAT, TIME, DATE, TIMESTAMP */
-        if (isdigit(c)) {
-            char buf[MAX_LEX];
-            int bi = 0;
-            int ch = c;
-            buf[bi++] = (char)c;
-
-            // collect digits, :, -, ., space as possible (stop on other chars)
-            while ((ch = peekch()) != EOF && (isdigit(ch) || ch == '.' || ch == ':' || ch == '-' || ch == ' ')) {
-                ch = getch();
-                if (bi < MAX_LEX - 1) buf[bi++] = (char)ch;
-            }
-            buf[bi] = '\0';
-
-            // Now determine classification
-            // Trim trailing spaces
-            int end = bi - 1;
-            while (end >= 0 && isspace((unsigned char)buf[end])) { buf[end] = '\0'; end--; }
-
-            // If contains '-' and looks like YYYY-MM-DD possibly followed by space+time -> DATE or TIMESTAMP
-            if (strchr(buf, '-') != NULL && looks_like_date_iso(buf)) {
-                // check if there is a space + time part -> timestamp
-                char *sp = strchr(buf, ' ');
-                if (sp != NULL) {
-                    // left is date, right is time -> TIMESTAMP
-                    char left[64]; left[0] = '\0';
-                    char right[128]; right[0] = '\0';
-                    size_t li = sp - buf;
-                    if (li >= sizeof(left)) li = sizeof(left)-1;
-                    strncpy(left, buf, li); left[li] = '\0';
-                    strncpy(right, sp+1, sizeof(right)-1); right[sizeof(right)-1] = '\0';
-                    if (looks_like_date_iso(left) && looks_like_time(right)) {
-                        add_symbol(buf, T_TIMESTAMP, start_line, start_col);
-                        continue;
-                    } else {
-                        if (looks_like_date_iso(left)) {
-                            add_symbol(left, T_DATE, start_line, start_col);
-                            for (int i = (int)strlen(right)-1; i >= 0; --i) ungetch(right[i]);
-                            continue;
-                        } else {
-                            add_symbol(buf, T_LEX_ERROR, start_line, start_col);
-                            continue;
-                        }
-                    }
-                } else {
-                    add_symbol(buf, T_DATE, start_line, start_col);
-                    continue;
-                }
-            }
-
-            // If contains ':' it's a TIME (HH:MM or HH:MM:SS)
-            if (strchr(buf, ':') != NULL && looks_like_time(buf)) {
-                add_symbol(buf, T_TIME, start_line, start_col);
-                continue;
-            }
-
-            // If contains '.' => float
-            if (strchr(buf, '.') != NULL) {
-                add_symbol(buf, T_FLOAT, start_line, start_col);
-                continue;
-            }
-
-            // Otherwise integer
-            add_symbol(buf, T_INT, start_line, start_col);
-            continue;
+static bool has_simp_ext(const char *name) {
+    size_t n = strlen(name);
+    return n > 5 && strcmp(name + n - 5, ".simp") == 0;
+}
+
+/* add a file, or every *.simp below a directory. Below it, symlinks to
+   files are followed but symlinks to directories are not, so a link back up
+   the tree (or out of it) cannot make the walk repeat or escape. */
+static int batch_collect(BatchList *bl, const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) { perror(path); return 0; }
+    if (!S_ISDIR(st.st_mode)) return batch_add(bl, path, (long long)st.st_size);
+
+    DIR *d = opendir(path);
+    if (!d) { perror(path); return 0; }
+    int ok = 1;
+    struct dirent *de;
+    while (ok && (de = readdir(d)) != NULL) {
+        if (de->d_name[0] == '.') continue;
+        char child[PATH_MAX];
+        snprintf(child, sizeof(child), "%s%c%s", path, PATH_SEP, de->d_name);
+        if (lstat(child, &st) != 0) { perror(child); continue; }
+#ifdef S_ISLNK
+        if (S_ISLNK(st.st_mode)) {
+            if (stat(child, &st) != 0) { perror(child); continue; }   // dangling
+            if (S_ISDIR(st.st_mode)) continue;
         }
+#endif
+        if (S_ISDIR(st.st_mode)) ok = batch_collect(bl, child);
+        else if (has_simp_ext(de->d_name)) ok = batch_add(bl, child, (long long)st.st_size);
+    }
+    closedir(d);
+    return ok;
+}
 
-        /* IDENTIFIER / KEYWORD / DATATYPE / RESERVED / NOISE + SPECIAL CASE: "to do" */
-        if (isalpha(c) || c == '_') {
-
-            char buf[MAX_LEX];
-            int bi = 0;
-            int ch = c;
-            buf[bi++] = (char)c;
-
-            while ((ch = peekch()) != EOF && (isalnum(ch) || ch == '_')) {
-                ch = getch();
-                if (bi < MAX_LEX - 1) buf[bi++] = (char)ch;
-            }
-            buf[bi] = '\0';
-
-            /* SPECIAL MERGE RULE FOR "to do" */
-            if (strcmp(buf, "to") == 0) {
-                int wc = peekch();
-                if (wc == ' ' || wc == '\t') {
-                    int ws_count = 0;
-                    int ww;
-                    while ((ww = peekch()) == ' ' || ww == '\t') {
-                        getch();
-                        ws_count++;
-                    }
-                    char next[16] = {0};
-                    int ni = 0;
-                    int nc = peekch();
-                    if (isalpha(nc)) {
-                        while ((nc = peekch()) != EOF && isalpha(nc)) {
-                            nc = getch();
-                            next[ni++] = (char)nc;
-                            if (ni >= 15) break;
-                        }
-                        next[ni] = '\0';
-                    }
-                    if (strcmp(next, "do") == 0) {
-                        strcpy(buf, "to do");
-                        add_symbol(buf, T_KEYWORD, start_line, start_col);
-                        continue;
-                    }
-                    for (int k = ni - 1; k >= 0; k--) ungetch(next[k]);
-                    for (int k = 0; k < ws_count; k++) ungetch(' ');
-                }
-            }
-
-            char low[MAX_LEX];
-            size_t L = strlen(buf);
-            for (size_t i = 0; i < L; ++i) low[i] = tolower((unsigned char)buf[i]);
-            low[L] = '\0';
-
-            /* Recognize boolean literals explicitly */
-            if (is_bool_literal(low)) {
-                add_symbol(buf, T_BOOL, start_line, start_col);
-                continue;
-            }
-
-            /* Recognize datatypes as their own token (declaration sites) */
-            if (is_datatype(low)) {
-                add_symbol(buf, T_DATATYPE, start_line, start_col);
-                continue;
-            }
-
-            /* Use lookup for keywords/reserved/noise */
-            int kclass = lookupKeyword(low); // returns 0=none,1=keyword,2=reserved,3=noise (assumed)
-            if (kclass == 1) add_symbol(buf, T_KEYWORD, start_line, start_col);
-            else if (kclass == 2) add_symbol(buf, T_RESERVED, start_line, start_col);
-            else if (kclass == 3) add_symbol(buf, T_NOISE, start_line, start_col);
-            else add_symbol(buf, T_IDENTIFIER, start_line, start_col);
+/* prog.simp -> prog.SymbolTable.txt, next to the source */
+static void batch_output_path(BatchFile *bf) {
+    size_t n = strlen(bf->path);
+    if (has_simp_ext(bf->path)) n -= 5;
+    snprintf(bf->outpath, sizeof(bf->outpath), "%.*s.SymbolTable.txt", (int)n, bf->path);
+}
 
-            continue;
+/* ctx is the --cache directory, or NULL */
+static void batch_lex_file(void *task, int worker, void *ctx) {
+    BatchFile *bf = task;
+    const char *cache_dir = ctx;
+    Lexer lex;
+    if (!lexer_open(&lex, bf->path)) { bf->failure = "cannot open file"; return; }
+
+    SymTable tab;
+    char entry[PATH_MAX + 32];
+    TcKey key = {0};
+    TokBin tb;
+    if (cache_dir) {
+        tc_key(&key, lex.src.data, lex.src.len);
+        tc_entry_path(entry, sizeof(entry), cache_dir, &key);
+        bf->cache_name = key.h1;
+        bf->cache_hit = tc_lookup(&tb, entry, &key, lex.src.data);
+    }
+    if (bf->cache_hit) {
+        /* the entry's tokens are spans of this very source */
+        Lexer cached;
+        if (load_token_binary(&tb, &cached, &tab)) {
+            symtab_free(&tab);
+            bf->cache_hit = false;   // unreadable entry: lex it again below
         }
-
-        /* TWO-CHAR LOOKAHEAD */
-        int nxt = peekch();
-        char twobuf[3] = {0};
-        if (nxt != EOF) {
-            twobuf[0] = (char)c;
-            twobuf[1] = (char)nxt;
-            twobuf[2] = '\0';
+        lexer_destroy(&cached);
+        tokbin_close(&tb);
+    }
+    if (!bf->cache_hit) {
+        /* the cache holds every token, trivia too, so fold after storing */
+        bf->failure = lex_into_table(&lex, &tab, fold_trivia && !cache_dir);
+        if (!bf->failure && cache_dir) {
+            char tag[32];
+            snprintf(tag, sizeof(tag), "%ld-%d", (long)getpid(), worker);
+            bf->cache_stored = tc_store(entry, tag, &tab, &key);
         }
+    }
+    if (!bf->failure && fold_trivia && !symtab_fold_trivia(&tab, lex.src.len)) bf->failure = "out of memory";
+    if (!bf->failure) {
+        bf->total = count_token_types(&tab, bf->counts);
+        batch_output_path(bf);
+        if (!write_symbol_table_to_path(&lex, &tab, bf->outpath)) bf->failure = "cannot write symbol table";
+    }
+    symtab_free(&tab);
+    lexer_destroy(&lex);
+}
 
-        // UNARY ++ -- (two-char) 
-        if (strcmp(twobuf, "++") == 0 || strcmp(twobuf, "--") == 0) {
-            getch(); getch();
-            add_symbol(twobuf, T_UNARY_OP, start_line, start_col);
-            continue;
-        }
+static int by_size_desc(const void *a, const void *b) {
+    const BatchFile *x = a, *y = b;
+    return (x->size < y->size) - (x->size > y->size);
+}
 
-        /* EXP ^ */
-        if (c == '^') {
-            add_symbol("^", T_EXP_OP, start_line, start_col);
-            continue;
-        }
+static int by_path(const void *a, const void *b) {
+    return strcmp(((const BatchFile *)a)->path, ((const BatchFile *)b)->path);
+}
 
-        /* RELATIONAL two-char (check before single '=') */
-        if (strcmp(twobuf, "<=") == 0 || strcmp(twobuf, ">=") == 0 ||
-            strcmp(twobuf, "==") == 0 || strcmp(twobuf, "!=") == 0) {
-            getch(); getch();
-            add_symbol(twobuf, T_REL_OP, start_line, start_col);
+/* aggregated Token Summary across all files of the batch */
+static int write_project_summary(const BatchList *bl, const char *outpath) {
+    OutBuf out, *f = &out;
+    if (!ob_open(f, outpath)) return 0;
+
+    long counts[T_COUNT] = {0};
+    long total = 0;
+    size_t failed = 0;
+
+    ob_lit(f, "=== SIMPLE LEXICAL ANALYZER PROJECT SUMMARY ===\n\n");
+    ob_lit(f, "------------- FILES -------------\n");
+    ob_lit(f, "   Tokens |   Errors | File\n");
+    ob_lit(f, "-------------------------------------------------------\n");
+    for (size_t i = 0; i < bl->count; ++i) {
+        const BatchFile *bf = &bl->files[i];
+        if (bf->failure) {
+            ob_printf(f, "        - |        - | %s (%s)\n", bf->path, bf->failure);
+            failed++;
             continue;
         }
+        ob_printf(f, "%9ld | %8ld | %s\n", bf->total, bf->counts[T_LEX_ERROR], bf->path);
+        for (int t = 0; t < T_COUNT; ++t) counts[t] += bf->counts[t];
+        total += bf->total;
+    }
 
-        /* ASSIGN two-char operators (+=, -=, *=, /=, %=, ~=) */
-        if (strcmp(twobuf, "+=") == 0 || strcmp(twobuf, "-=") == 0 ||
-            strcmp(twobuf, "*=") == 0 || strcmp(twobuf, "/=") == 0 ||
-            strcmp(twobuf, "%=") == 0 || strcmp(twobuf, "~=") == 0) {
-            getch(); getch();
-            add_symbol(twobuf, T_ASSIGN_OP, start_line, start_col);
-            continue;
-        }
-        /* single '=' assign (after checking '==') */
-        if (c == '=') {
-            add_symbol("=", T_ASSIGN_OP, start_line, start_col);
-            continue;
-        }
+    write_token_summary(f, counts, total);
+    ob_printf(f, "Files: %zu lexed, %zu failed\n", bl->count - failed, failed);
 
-        /* single < or > */
-        if (c == '<' || c == '>') {
-            char t[2] = {(char)c, '\0'};
-            add_symbol(t, T_REL_OP, start_line, start_col);
-            continue;
-        }
+    return ob_close(f);
+}
 
-        /* LOGICAL */
-        if (strcmp(twobuf, "&&") == 0 || strcmp(twobuf, "||") == 0) {
-            getch(); getch();
-            add_symbol(twobuf, T_LOGICAL_OP, start_line, start_col);
-            continue;
-        }
-        if (c == '!') {
-            /* '!=' handled above; single '!' logical NOT */
-            add_symbol("!", T_LOGICAL_OP, start_line, start_col);
-            continue;
+/* cache_prune: afterwards remove the entries of cache_dir this batch did not use */
+static int run_batch(char **inputs, int ninputs, int threads, const char *outarg, const char *cache_dir,
+                     bool cache_prune, FILE *msg) {
+    if (cache_dir && !tc_prepare_dir(cache_dir)) { fprintf(stderr, "%s: cannot use as cache directory\n", cache_dir); return 1; }
+    BatchList bl = {0};
+    for (int i = 0; i < ninputs; ++i)
+        if (!batch_collect(&bl, inputs[i])) return 1;
+    if (bl.count == 0) { fprintf(stderr, "No .simp files found.\n"); return 1; }
+
+    /* biggest files first so the long ones start early and the small ones fill the gaps */
+    qsort(bl.files, bl.count, sizeof(*bl.files), by_size_desc);
+    void **tasks = malloc(bl.count * sizeof(void *));
+    if (!tasks) { fprintf(stderr, "Out of memory\n"); return 1; }
+    for (size_t i = 0; i < bl.count; ++i) tasks[i] = &bl.files[i];
+
+    if (threads < 1) threads = pool_default_threads();
+    int ran = pool_run(threads, tasks, bl.count, batch_lex_file, (void *)cache_dir);
+    free(tasks);
+    if (!ran) { fprintf(stderr, "Could not start worker threads.\n"); return 1; }
+
+    qsort(bl.files, bl.count, sizeof(*bl.files), by_path);
+    const char *summary = outarg ? outarg : "ProjectSummary.txt";
+    int written = write_project_summary(&bl, summary);
+
+    /* --cache-prune keeps the entries of every file read, hit or not */
+    uint64_t *keep = cache_prune ? malloc(bl.count * sizeof(*keep)) : NULL;
+    size_t failed = 0, hits = 0, stored = 0;
+    for (size_t i = 0; i < bl.count; ++i) {
+        if (bl.files[i].failure) {
+            fprintf(stderr, "%s: %s\n", bl.files[i].path, bl.files[i].failure);
+            failed++;
         }
+        hits += bl.files[i].cache_hit;
+        stored += bl.files[i].cache_stored;
+        if (keep) keep[i] = bl.files[i].cache_name;
+        free(bl.files[i].path);
+    }
+    long pruned = !cache_prune ? 0 : keep ? tc_prune(cache_dir, keep, bl.count) : -1;
+    free(keep);
+    free(bl.files);
+
+    if (!written) fprintf(msg, "Failed to write project summary.\n");
+    else if (strcmp(summary, "-") != 0) fprintf(msg, "Project summary saved to: %s\n", summary);
+    if (cache_dir)
+        fprintf(msg, "Cache %s: %zu hits, %zu misses (%zu stored)\n", cache_dir, hits, bl.count - hits, stored);
+    if (cache_prune && pruned < 0) fprintf(stderr, "%s: cannot prune the cache\n", cache_dir);
+    else if (cache_prune) fprintf(msg, "Cache %s: %ld stale entries removed\n", cache_dir, pruned);
+    fprintf(msg, "Analysis Complete.\n");
+    return (written && failed == 0) ? 0 : 1;
+}
 
-        /* ARITHMETIC and UNARY single-char handling */
-        /* First, treat multiplication, division, modulo, integer division ~, percent, etc. */
-        if (c == '*' || c == '%' || c == '~') {
-            char t[2] = {(char)c, '\0'};
-            add_symbol(t, T_ARITH_OP, start_line, start_col);
-            continue;
-        }
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [--stream | --json | --binary | --from-binary] [--fold-trivia] [--elements] [-j N] [-o OUTPUT] [FILE]\n", prog);
+    fprintf(stderr, "       %s --batch [-j N] [-o SUMMARY] [--cache DIR [--cache-prune]] [--fold-trivia] [--elements] FILE|DIR...\n", prog);
+    fprintf(stderr, "  FILE        SIMPLE source (\"-\" = stdin); prompted for when omitted\n");
+    fprintf(stderr, "  -o OUTPUT   symbol table path (\"-\" = stdout), default ./SymbolTable.txt\n");
+    fprintf(stderr, "  --stream    write each token as it is scanned, in constant memory\n");
+    fprintf(stderr, "  --json      stream JSON Lines: one object per token, then a summary object\n");
+    fprintf(stderr, "              (default ./SymbolTable.jsonl)\n");
+    fprintf(stderr, "  --binary    write a binary token stream (see tokbin.h), default ./SymbolTable.tok\n");
+    fprintf(stderr, "  --from-binary  FILE is such a token stream; write it out as the text table\n");
+    fprintf(stderr, "  --batch     lex many files in parallel; each gets NAME.SymbolTable.txt next to it\n");
+    fprintf(stderr, "              and the combined summary goes to SUMMARY (./ProjectSummary.txt)\n");
+    fprintf(stderr, "  --cache DIR keep each file's tokens in DIR, keyed by a hash of its contents, and\n");
+    fprintf(stderr, "              reuse them for files that have not changed. Entries are never removed\n");
+    fprintf(stderr, "              on their own, so DIR grows as files are edited; see --cache-prune\n");
+    fprintf(stderr, "  --cache-prune  after the batch, remove the entries in DIR it did not use\n");
+    fprintf(stderr, "              (those of edited or deleted files, or of other projects sharing DIR)\n");
+    fprintf(stderr, "  -j N        worker threads: files in parallel for --batch (default: one per CPU),\n");
+    fprintf(stderr, "              otherwise chunks of the single input (default: 1)\n");
+    fprintf(stderr, "  --fold-trivia  leave whitespace, newline and comment rows out (--json attaches\n");
+    fprintf(stderr, "              them to the next token as \"trivia\"); the summary still counts them\n");
+    fprintf(stderr, "  --elements  list the tokens inside each ARRAY and COLLECTION under its row\n");
+    fprintf(stderr, "              (symbol tables only; they are not counted in the summary)\n");
+    fprintf(stderr, "  --stats     print a profile of the run (needs a build with -DSIMPLE_STATS)\n");
+    fprintf(stderr, "  --perf      --stats plus hardware counters per phase (Linux perf_event_open)\n");
+}
 
-        // For '/': handled above in comment block, but keep fallback
-        if (c == '/') {
-            add_symbol("/", T_ARITH_OP, start_line, start_col);
-            continue;
-        }
+int main(int argc, char **argv) {
+    char filename[PATH_MAX] = "";
+    const char *outarg = NULL, *cache_dir = NULL;
+    bool streaming = false, batch = false, binary = false, from_binary = false, stats = false, perf = false;
+    bool cache_prune = false;
+    int threads = 0;
+    char **inputs = calloc((size_t)argc, sizeof(char *));
+    int ninputs = 0;
+    if (!inputs) return 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--stream") == 0) streaming = true;
+        else if (strcmp(argv[i], "--batch") == 0) batch = true;
+        else if (strcmp(argv[i], "--json") == 0) streaming = stream_json = true;
+        else if (strcmp(argv[i], "--binary") == 0) binary = true;
+        else if (strcmp(argv[i], "--from-binary") == 0) from_binary = true;
+        else if (strcmp(argv[i], "--fold-trivia") == 0) fold_trivia = true;
+        else if (strcmp(argv[i], "--elements") == 0) show_elements = true;
+        else if (strcmp(argv[i], "--stats") == 0) stats = true;
+        else if (strcmp(argv[i], "--perf") == 0) stats = perf = true;
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) outarg = argv[++i];
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) cache_dir = argv[++i];
+        else if (strcmp(argv[i], "--cache-prune") == 0) cache_prune = true;
+        else if (argv[i][0] == '-' && argv[i][1] != '\0') { usage(argv[0]); return 1; }
+        else inputs[ninputs++] = argv[i];
+    }
+    if ((batch && (streaming || binary || from_binary || ninputs == 0)) || (!batch && ninputs > 1) ||
+        streaming + binary + from_binary > 1 || (cache_dir && !batch) || (cache_prune && !cache_dir) || (stats && (batch || from_binary)) ||
+        (fold_trivia && (binary || from_binary)) || (show_elements && (streaming || binary))) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (stats) {
+#ifdef SIMPLE_STATS
+        /* the counters are not shared between threads */
+        stats_enabled = 1;
+        threads = 1;
+        const char *why = perf ? pc_open(&stats_pc) : NULL;
+        if (why) fprintf(stderr, "--perf: %s; timing only\n", why);
+#else
+        fprintf(stderr, "--%s: this build has no instrumentation; rebuild with -DSIMPLE_STATS\n",
+                perf ? "perf" : "stats");
+        stats = false;
+#endif
+    }
 
-        /* PLUS and MINUS: decide unary vs binary */
-        if (c == '+' || c == '-') {
-            /* ++/-- already handled above */
-            bool unary = prev_allows_unary();
-            char t[2] = {(char)c, '\0'};
-            if (unary) add_symbol(t, T_UNARY_OP, start_line, start_col);
-            else add_symbol(t, T_ARITH_OP, start_line, start_col);
-            continue;
-        }
+    /* status lines go to stderr when the table itself is written to stdout */
+    bool to_stdout = outarg && strcmp(outarg, "-") == 0;
+    FILE *msg = to_stdout ? stderr : stdout;
 
-        /* DELIMITERS (other than brackets) */
-        if (c == ':') { add_symbol(":", T_COLON, start_line, start_col); continue; }
-        if (c == ',') { add_symbol(",", T_COMMA, start_line, start_col); continue; }
-        if (c == '(') { add_symbol("(", T_LPAREN, start_line, start_col); continue; }
-        if (c == ')') { add_symbol(")", T_RPAREN, start_line, start_col); continue; }
-        if (c == ']') { add_symbol("]", T_RBRACKET, start_line, start_col); continue; }
-
-        /* UNKNOWN CHARACTER -> lexical error */
-        {
-            char tmp[2] = {(char)c, '\0'};
-            add_symbol(tmp, T_LEX_ERROR, start_line, start_col);
-            continue;
-        }
+    fprintf(msg, "\n === SIMPLE Lexical Analyzer ===\n\n");
+    if (batch) {
+        int rc = run_batch(inputs, ninputs, threads, outarg, cache_dir, cache_prune, msg);
+        free(inputs);
+        return rc;
     }
+    if (ninputs == 1) {
+        /* file given on the command line ("-" reads the source from stdin) */
+        strncpy(filename, inputs[0], sizeof(filename) - 1);
+        filename[sizeof(filename) - 1] = '\0';
+    }
+    free(inputs);
 
-    fclose(infile);
+    if (!filename[0]) {
+        fprintf(msg, "Enter SIMPLE source file: ");
+        fflush(msg);
+        if (!fgets(filename, sizeof(filename), stdin)) return 1;
+        filename[strcspn(filename, "\r\n")] = 0;
+    }
 
-    char cwd[PATH_MAX];
-    getcwd(cwd, sizeof(cwd));
+    Lexer lex;
+    TokBin tb;
+    STATS_START(t_read);
+    if (from_binary) {
+        if (!tokbin_open(&tb, filename)) { fprintf(stderr, "%s: cannot read token file\n", filename); return 1; }
+    } else if (!lexer_open(&lex, filename)) {
+        perror("Cannot open file\nOnly .simp file extension will be read");
+        return 1;
+    }
+    STATS_PHASE(PHASE_READ, t_read);
 
     char outpath[PATH_MAX + 64];
-    snprintf(outpath, sizeof(outpath), "%s%cSymbolTable.txt", cwd, PATH_SEP);
+    if (outarg) {
+        snprintf(outpath, sizeof(outpath), "%s", outarg);
+    } else {
+        char cwd[PATH_MAX];
+        getcwd(cwd, sizeof(cwd));
+        snprintf(outpath, sizeof(outpath), "%s%cSymbolTable.%s", cwd, PATH_SEP,
+                 binary ? "tok" : stream_json ? "jsonl" : "txt");
+    }
 
-    if (!write_symbol_table_to_path(outpath))
-        printf("Failed to write output.\n");
-    else printf("Symbol Table saved to: %s\n", outpath);
-    printf("Analysis Complete.\n");
+    if (streaming) {
+        if (!ob_open(&stream_out, outpath)) { fprintf(msg, "Failed to write output.\n"); return 1; }
+        if (!stream_json) write_table_header(&stream_out);
+        lc_init(&stream_lines, lex.src.data);
+        fold_init(&stream_fold);
+    }
+
+    /* lexemes point into the source buffer, so it stays open until written */
+    int written;
+    if (streaming) {
+        Token tok;
+        STATS_START(t_loop);
+        while (lexer_next(&lex, &tok)) {
+            STATS_START(t_row);
+            stream_symbol(&lex, &tok);
+            STATS_PHASE(PHASE_WRITE, t_row);
+        }
+        STATS_PHASE(PHASE_LEX, t_loop);
+#ifdef SIMPLE_STATS
+        /* the loop measured both */
+        lex_stats.phase_ns[PHASE_LEX] -= lex_stats.phase_ns[PHASE_WRITE];
+        for (int k = 0; k < PC_COUNT; ++k) lex_stats.phase_ctr[PHASE_LEX][k] -= lex_stats.phase_ctr[PHASE_WRITE][k];
+#endif
+        STATS_START(t_tail);
+        write_stream_tail(&lex, &stream_out);
+        written = ob_close(&stream_out);
+        STATS_PHASE(PHASE_WRITE, t_tail);
+        free(stream_errs);
+    } else {
+        SymTable tab;
+        STATS_START(t_lex);
+        const char *why = from_binary ? load_token_binary(&tb, &lex, &tab)
+                        : threads > 1 ? lex_into_table_parallel(&lex, &tab, threads)
+                                      : lex_into_table(&lex, &tab, fold_trivia);
+        if (!why && fold_trivia && !symtab_fold_trivia(&tab, lex.src.len)) why = "out of memory";
+        if (why) { fprintf(stderr, "%s\n", why); return 1; }
+        STATS_PHASE(PHASE_LEX, t_lex);
+        STATS_START(t_write);
+        written = binary ? write_token_binary_to_path(&lex, &tab, outpath)
+                         : write_symbol_table_to_path(&lex, &tab, outpath);
+        STATS_PHASE(PHASE_WRITE, t_write);
+        symtab_free(&tab);
+    }
+
+    if (!written)
+        fprintf(msg, "Failed to write output.\n");
+    else if (!to_stdout) fprintf(msg, "%s saved to: %s\n", binary ? "Token stream" : stream_json ? "Tokens" : "Symbol Table", outpath);
+#ifdef SIMPLE_STATS
+    if (stats) {
+        SymTable *row = NULL;   // only for the sizes of its columns
+        stats_report(msg, token_names, T_COUNT, lex.src.len,
+                     sizeof(*row->type) + sizeof(*row->flags) + sizeof(*row->off) + sizeof(*row->len) +
+                         (fold_trivia ? sizeof(*row->lead) : 0));
+        pc_close(&stats_pc);
+    }
+#endif
+    fprintf(msg, "Analysis Complete.\n");
 
+    lexer_destroy(&lex);
+    if (from_binary) tokbin_close(&tb);
     return 0;
 }
@@ -0,0 +1,122 @@
+// Whole-file input buffer for the SIMPLE lexer.
+// The source is memory-mapped when possible (regular files on POSIX) and
+// otherwise read once into a heap buffer (pipes, FIFOs, stdin, Windows),
+// so the scanner walks a plain byte array with a cursor instead of calling
+// into stdio for every character.
+
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+typedef struct {
+    const char *data;   // source bytes (not NUL-terminated)
+    size_t len;         // number of bytes in data
+    size_t pos;         // cursor: index of the next byte to read
+    int mapped;         // 1 = data is an mmap view, 0 = heap buffer (or empty)
+} SourceBuf;
+
+static const char src_empty[1] = "";
+
+// read everything from an open stream into a heap buffer
+static int src_read_stream(SourceBuf *s, FILE *f) {
+    size_t cap = 1 << 16, n = 0;
+    char *buf = malloc(cap);
+    if (!buf) return 0;
+    for (;;) {
+        if (n == cap) {
+            char *nb = realloc(buf, cap * 2);
+            if (!nb) { free(buf); return 0; }
+            buf = nb;
+            cap *= 2;
+        }
+        size_t got = fread(buf + n, 1, cap - n, f);
+        n += got;
+        if (got == 0) break;
+    }
+    if (ferror(f)) { free(buf); return 0; }
+    s->data = buf;
+    s->len = n;
+    s->pos = 0;
+    s->mapped = 0;
+    return 1;
+}
+
+// open path ("-" means stdin); returns 1 on success, 0 on failure (errno set)
+static int src_open(SourceBuf *s, const char *path) {
+    memset(s, 0, sizeof(*s));
+    s->data = src_empty;
+
+    if (strcmp(path, "-") == 0) return src_read_stream(s, stdin);
+
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        if (st.st_size == 0) { close(fd); return 1; }
+        void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+            madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+            close(fd);
+            s->data = p;
+            s->len = (size_t)st.st_size;
+            s->mapped = 1;
+            return 1;
+        }
+    }
+    // not a regular file (pipe, FIFO, device) or mmap refused: read it once
+    FILE *f = fdopen(fd, "r");
+    if (!f) { close(fd); return 0; }
+#else
+    // text mode keeps the CRLF -> LF translation the stdio scanner relied on
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+#endif
+    int ok = src_read_stream(s, f);
+    fclose(f);
+    return ok;
+}
+
+static void src_close(SourceBuf *s) {
+#ifndef _WIN32
+    if (s->mapped) munmap((void *)s->data, s->len);
+    else
+#endif
+    if (s->data != src_empty) free((void *)s->data);
+    memset(s, 0, sizeof(*s));
+    s->data = src_empty;
+}
+
+// Let the OS drop mapped pages before off. The mapping stays valid: pages
+// are faulted back in from the file if a lexeme there is printed later.
+// Heap buffers (pipes, stdin) are left alone.
+static inline void src_release_before(SourceBuf *s, size_t off) {
+#if !defined(_WIN32) && defined(MADV_DONTNEED)
+    if (!s->mapped) return;
+    long page = sysconf(_SC_PAGESIZE);
+    size_t n = page > 0 ? off - off % (size_t)page : 0;
+    if (n) madvise((void *)s->data, n, MADV_DONTNEED);
+#else
+    (void)s; (void)off;
+#endif
+}
+
+// byte at cursor + ahead, or EOF past the end (lookahead never consumes)
+static inline int src_peek(const SourceBuf *s, size_t ahead) {
+    size_t i = s->pos + ahead;
+    return i < s->len ? (unsigned char)s->data[i] : EOF;
+}
+
+#endif // SOURCE_H
@@ -0,0 +1,175 @@
+// Opt-in instrumentation for simple_lex --stats.
+// Build with -DSIMPLE_STATS to compile it in:
+//
+//     gcc -O2 -pthread -DSIMPLE_STATS -o simple_lex simple_lex.c
+//
+// Without it every STATS_* macro expands to nothing and the lexer is the
+// same code as before. With it, and only while stats_enabled is set, the
+// run records wall time and call counts per phase, and per token type the
+// number of tokens, their bytes and the time of the scans that produced
+// them (attributed to the first token of each scan). Every timed scan costs
+// two clock reads, so the lex phase runs somewhat slower than without
+// --stats; the split between types is what the numbers are for.
+//
+// --perf adds the hardware counters of perfctr.h to every phase (not to
+// the per-type scan times, which would need two system calls per token).
+// The keyword lookup and number phases are read around each call, so their
+// cache figures include what those reads disturb.
+//
+// The counters are plain globals: --stats runs lex on one thread.
+
+#ifndef STATS_H
+#define STATS_H
+
+#ifdef SIMPLE_STATS
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#ifndef _WIN32
+  #include <sys/resource.h>
+#endif
+
+#include "perfctr.h"
+
+enum { PHASE_READ, PHASE_LEX, PHASE_WORDS, PHASE_NUMBERS, PHASE_WRITE, PHASE_COUNT };
+
+static const char *const stats_phase_names[PHASE_COUNT] = {
+    "read input", "lex", "  keyword lookup", "  number/date/time scans", "write output",
+};
+
+#define STATS_MAX_TYPES 64
+
+typedef struct {
+    uint64_t phase_ns[PHASE_COUNT];
+    uint64_t phase_calls[PHASE_COUNT];
+    uint64_t phase_ctr[PHASE_COUNT][PC_COUNT];   // --perf only
+    uint64_t scan_ns[STATS_MAX_TYPES];   // by the type of the first token of a scan
+    uint64_t scans[STATS_MAX_TYPES];
+    uint64_t tokens[STATS_MAX_TYPES];
+    uint64_t bytes[STATS_MAX_TYPES];     // lexeme bytes of those tokens
+} LexStats;
+
+static LexStats lex_stats;
+static int stats_enabled = 0;
+static PerfCounters stats_pc;   // opened by --perf; stats_pc.nfd == 0 otherwise
+
+static inline uint64_t stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+typedef struct {
+    uint64_t ns;
+    uint64_t ctr[PC_COUNT];
+} StatsMark;
+
+static inline void stats_mark(StatsMark *m) {
+    if (!stats_enabled) return;
+    if (stats_pc.nfd) pc_read(&stats_pc, m->ctr);
+    m->ns = stats_now();
+}
+
+static inline void stats_phase_end(int phase, const StatsMark *m) {
+    if (!stats_enabled) return;
+    uint64_t end = stats_now();
+    lex_stats.phase_ns[phase] += end - m->ns;
+    lex_stats.phase_calls[phase]++;
+    if (stats_pc.nfd) {
+        uint64_t c[PC_COUNT];
+        pc_read(&stats_pc, c);
+        for (int k = 0; k < PC_COUNT; ++k) lex_stats.phase_ctr[phase][k] += c[k] - m->ctr[k];
+    }
+}
+
+#define STATS_START(v) StatsMark v = {0, {0}}; stats_mark(&v)
+#define STATS_PHASE(phase, v) stats_phase_end((phase), &(v))
+#define STATS_SCAN_START(v) uint64_t v = stats_enabled ? stats_now() : 0
+/* a scan that started at v queued tokens q[0, n) */
+#define STATS_SCAN(v, q, n)                                        \
+    do {                                                           \
+        if (stats_enabled && (n) > 0) {                            \
+            lex_stats.scan_ns[(q)[0].type] += stats_now() - (v);   \
+            lex_stats.scans[(q)[0].type]++;                        \
+            for (int si_ = 0; si_ < (n); ++si_) {                  \
+                lex_stats.tokens[(q)[si_].type]++;                 \
+                lex_stats.bytes[(q)[si_].type] += (q)[si_].len;    \
+            }                                                      \
+        }                                                          \
+    } while (0)
+
+// peak resident set size in kB, -1 where unknown
+static long stats_peak_rss_kb(void) {
+#ifndef _WIN32
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0) return ru.ru_maxrss;
+#endif
+    return -1;
+}
+
+// counters per phase: IPC and events per token ("-" = not counted here)
+static void stats_report_counters(FILE *f, uint64_t tokens) {
+    fprintf(f, "\n%-26s %14s %14s %6s", "Counters", "cycles", "instructions", "IPC");
+    for (int k = PC_BRANCH_MISSES; k < PC_COUNT; ++k) fprintf(f, " %13s", pc_names[k]);
+    fprintf(f, "\n%-26s %14s %14s %6s", "", "", "", "");
+    for (int k = PC_BRANCH_MISSES; k < PC_COUNT; ++k) fprintf(f, " %13s", "per token");
+    fprintf(f, "\n");
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        const uint64_t *c = lex_stats.phase_ctr[p];
+        fprintf(f, "%-26s", stats_phase_names[p]);
+        for (int k = PC_CYCLES; k <= PC_INSTRUCTIONS; ++k) {
+            if (stats_pc.have[k]) fprintf(f, " %14llu", (unsigned long long)c[k]);
+            else fprintf(f, " %14s", "-");
+        }
+        if (stats_pc.have[PC_CYCLES] && stats_pc.have[PC_INSTRUCTIONS] && c[PC_CYCLES])
+            fprintf(f, " %6.2f", (double)c[PC_INSTRUCTIONS] / (double)c[PC_CYCLES]);
+        else
+            fprintf(f, " %6s", "-");
+        for (int k = PC_BRANCH_MISSES; k < PC_COUNT; ++k) {
+            if (stats_pc.have[k]) fprintf(f, " %13.4f", tokens ? (double)c[k] / (double)tokens : 0.0);
+            else fprintf(f, " %13s", "-");
+        }
+        fprintf(f, "\n");
+    }
+}
+
+/* The profile report: phases, the per-type table, and the memory figures.
+   bytes_per_table_row is what the symbol table stores per token. */
+static void stats_report(FILE *f, const char *const *type_names, int ntypes, size_t input_bytes,
+                         size_t bytes_per_table_row) {
+    uint64_t tokens = 0;
+    fprintf(f, "\n--- Profile (--stats) ---\n");
+    fprintf(f, "%-26s %10s %12s %10s\n", "Phase", "ms", "calls", "ns/call");
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        uint64_t calls = lex_stats.phase_calls[p];
+        fprintf(f, "%-26s %10.2f %12llu %10.1f\n", stats_phase_names[p], lex_stats.phase_ns[p] / 1e6,
+                (unsigned long long)calls, calls ? (double)lex_stats.phase_ns[p] / (double)calls : 0.0);
+    }
+
+    fprintf(f, "\n%-15s %12s %12s %10s %10s\n", "Token", "tokens", "bytes", "scan ms", "ns/scan");
+    for (int t = 0; t < ntypes && t < STATS_MAX_TYPES; ++t) {
+        if (!lex_stats.tokens[t] && !lex_stats.scans[t]) continue;
+        tokens += lex_stats.tokens[t];
+        fprintf(f, "%-15s %12llu %12llu %10.2f %10.1f\n", type_names[t], (unsigned long long)lex_stats.tokens[t],
+                (unsigned long long)lex_stats.bytes[t], lex_stats.scan_ns[t] / 1e6,
+                lex_stats.scans[t] ? (double)lex_stats.scan_ns[t] / (double)lex_stats.scans[t] : 0.0);
+    }
+
+    fprintf(f, "\nInput: %zu bytes, %llu tokens, %.2f bytes/token; table: %zu bytes/token\n", input_bytes,
+            (unsigned long long)tokens, tokens ? (double)input_bytes / (double)tokens : 0.0, bytes_per_table_row);
+    long rss = stats_peak_rss_kb();
+    if (rss >= 0) fprintf(f, "Peak RSS: %.1f MB\n", rss / 1024.0);
+    if (stats_pc.nfd) stats_report_counters(f, tokens);
+}
+
+#else
+
+#define STATS_START(v)
+#define STATS_PHASE(phase, v)
+#define STATS_SCAN_START(v)
+#define STATS_SCAN(v, q, n)
+
+#endif // SIMPLE_STATS
+
+#endif // STATS_H
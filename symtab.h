@@ -0,0 +1,135 @@
+// Growable token table for the SIMPLE lexer.
+// Tokens are stored column-wise (one packed array per field) so passes that
+// only need token types, such as the Token Summary, walk a single byte array.
+// Lexemes are (offset, length) spans into the source buffer; line and column
+// are not stored but looked up from the offset (lineindex.h) when printed.
+// Parsed literal values (SYMF_VALUE tokens, numlit.h) are kept aside like
+// the error list, since most tokens have none.
+
+#ifndef SYMTAB_H
+#define SYMTAB_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "numlit.h"  // LitValue
+
+typedef struct {
+    uint8_t  *type;     // SymType
+    uint8_t  *flags;    // SYMF_* bits
+    uint32_t *off;      // lexeme start in the source buffer
+    uint32_t *len;      // lexeme length in bytes
+    size_t count;
+    size_t cap;
+
+    uint32_t *errs;     // indexes of T_LEX_ERROR tokens, in source order
+    size_t errcount;
+    size_t errcap;
+
+    uint32_t *vidx;     // indexes of tokens with a parsed value, in source order ...
+    LitValue *vals;     // ... and those values
+    size_t valcount;
+    size_t valcap;
+
+    /* trivia-folded tables only (trivia.h); lead is NULL otherwise */
+    uint32_t *lead;     // start of the trivia before each token
+    uint32_t tail;      // start of the trivia after the last token
+    size_t folded[3];   // trivia tokens not stored, by SymType (NEWLINE, WHITESPACE, COMMENT)
+} SymTable;
+
+static void symtab_free(SymTable *t) {
+    free(t->type); free(t->flags);
+    free(t->off);  free(t->len);
+    free(t->errs); free(t->lead);
+    free(t->vidx); free(t->vals);
+    memset(t, 0, sizeof(*t));
+}
+
+// grow every column to hold at least cap tokens; returns 0 when out of memory
+static int symtab_reserve(SymTable *t, size_t cap) {
+    if (cap <= t->cap) return 1;
+    void *p;
+#define SYMTAB_GROW(col) \
+    if (!(p = realloc(t->col, cap * sizeof(*t->col)))) return 0; \
+    t->col = p;
+    SYMTAB_GROW(type)
+    SYMTAB_GROW(flags)
+    SYMTAB_GROW(off)
+    SYMTAB_GROW(len)
+    if (t->lead) { SYMTAB_GROW(lead) }
+#undef SYMTAB_GROW
+    t->cap = cap;
+    return 1;
+}
+
+// source text averages roughly one token per three bytes; sizing the columns
+// from the input length up front means typical files never reallocate
+static int symtab_init(SymTable *t, size_t source_len) {
+    memset(t, 0, sizeof(*t));
+    return symtab_reserve(t, source_len / 3 + 64);
+}
+
+// append one token; is_error also records it in the error list
+static int symtab_push(SymTable *t, uint8_t type, uint8_t flags, uint32_t off, uint32_t len, int is_error) {
+    if (t->count == t->cap && !symtab_reserve(t, t->cap ? t->cap * 2 : 64)) return 0;
+    size_t i = t->count;
+    if (is_error) {
+        if (t->errcount == t->errcap) {
+            size_t ncap = t->errcap ? t->errcap * 2 : 64;
+            uint32_t *ne = realloc(t->errs, ncap * sizeof(*ne));
+            if (!ne) return 0;
+            t->errs = ne;
+            t->errcap = ncap;
+        }
+        t->errs[t->errcount++] = (uint32_t)i;
+    }
+    t->type[i] = type;
+    t->flags[i] = flags;
+    t->off[i] = off;
+    t->len[i] = len;
+    t->count++;
+    return 1;
+}
+
+// room for at least cap values; returns 0 when out of memory
+static int symtab_reserve_values(SymTable *t, size_t cap) {
+    if (cap <= t->valcap) return 1;
+    uint32_t *ni = realloc(t->vidx, cap * sizeof(*ni));
+    if (!ni) return 0;
+    t->vidx = ni;
+    LitValue *nv = realloc(t->vals, cap * sizeof(*nv));
+    if (!nv) return 0;
+    t->vals = nv;
+    t->valcap = cap;
+    return 1;
+}
+
+// record v as the value of the token pushed last; returns 0 when out of memory
+static int symtab_push_value(SymTable *t, LitValue v) {
+    if (t->valcount == t->valcap && !symtab_reserve_values(t, t->valcap ? t->valcap * 2 : 64)) return 0;
+    t->vidx[t->valcount] = (uint32_t)(t->count - 1);
+    t->vals[t->valcount++] = v;
+    return 1;
+}
+
+// position in the value list of the first value of token i or later
+static inline size_t symtab_value_slot(const SymTable *t, size_t i) {
+    size_t lo = 0, hi = t->valcount;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (t->vidx[mid] < i) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// the value of token i, if it has one; returns 0 if not
+static inline int symtab_value(const SymTable *t, size_t i, LitValue *v) {
+    size_t k = symtab_value_slot(t, i);
+    if (k == t->valcount || t->vidx[k] != i) return 0;
+    *v = t->vals[k];
+    return 1;
+}
+
+#endif // SYMTAB_H
@@ -0,0 +1,279 @@
+// Binary token stream: the symbol table in a form tools can mmap and walk
+// without parsing text. Lexemes are kept losslessly as spans of the source,
+// unlike SymbolTable.txt where, for instance, every newline prints as "\n".
+//
+// Layout (integers little-endian):
+//
+//     header   64 bytes
+//                0  "SIMPTOK\0"
+//                8  u32 version (TOKBIN_VERSION)
+//               12  u32 ntypes      entries in the type dictionary
+//               16  u64 ntokens
+//               24  u64 dict_off    type dictionary
+//               32  u64 str_off     string section
+//               40  u64 str_len
+//               48  u64 tok_off     token records
+//               56  u64 tok_len
+//     dict     ntypes x (u8 length, name bytes): the name of type byte i
+//     strings  the source text; every lexeme is a span of it
+//     tokens   ntokens records of
+//                u8     type
+//                u8     flags       SYMF_* bits as the lexer set them
+//                varint zigzag(off - end of previous lexeme)   (usually 0)
+//                varint len
+//                varint zigzag(value)   only if flags has TOKBIN_VALUE: a
+//                                       literal's value (numlit.h), a
+//                                       FLOAT as the bits of its double
+//
+// Varints are LEB128: 7 bits per byte, low bits first, high bit = more.
+// Lines and columns are not stored; like the lexer's own tokens they follow
+// from the offsets, through a line index over the string section.
+//
+// Writing:   tokbin_write(out, tab, src, src_len, names, ntypes);
+// Reading:
+//     TokBin tb;
+//     TokBinIter it;
+//     TokBinToken t;
+//     if (!tokbin_open(&tb, "prog.tok")) ...;      // or tokbin_load() on a buffer
+//     tokbin_iter_init(&it, &tb);
+//     while (tokbin_next(&it, &t) > 0) { ... tb.str + t.off, t.len ... }
+//     tokbin_close(&tb);
+
+#ifndef TOKBIN_H
+#define TOKBIN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "outbuf.h"
+#include "source.h"
+#include "symtab.h"
+
+#define TOKBIN_MAGIC "SIMPTOK"   // plus its NUL: 8 bytes
+#define TOKBIN_VERSION 3
+#define TOKBIN_HEADER 64
+#define TOKBIN_MAX_RECORD 32     // 2 type/flag bytes + 3 varints of 64-bit values (10 bytes each)
+#define TOKBIN_VALUE 0x10        // the flag bit of records with a value (SYMF_VALUE in lexer.h)
+
+/* ---------- encoding ---------- */
+
+static inline uint64_t tb_zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t tb_unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static inline uint8_t *tb_put_varint(uint8_t *p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static inline void tb_put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static inline void tb_put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static inline uint32_t tb_get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static inline uint64_t tb_get_u64(const uint8_t *p) {
+    return (uint64_t)tb_get_u32(p) | (uint64_t)tb_get_u32(p + 4) << 32;
+}
+
+// delta state shared by the encoder and the decoder
+typedef struct {
+    uint64_t end;   // off + len of the previous token
+    size_t val;     // encoder: next entry of the table's value list
+} TokBinPrev;
+
+// encode token i of tab at p (room for TOKBIN_MAX_RECORD bytes); returns the end
+static inline uint8_t *tb_encode(uint8_t *p, const SymTable *tab, size_t i, TokBinPrev *prev) {
+    bool has_value = prev->val < tab->valcount && tab->vidx[prev->val] == i;
+    *p++ = tab->type[i];
+    *p++ = (uint8_t)((tab->flags[i] & ~TOKBIN_VALUE) | (has_value ? TOKBIN_VALUE : 0));
+    p = tb_put_varint(p, tb_zigzag((int64_t)tab->off[i] - (int64_t)prev->end));
+    p = tb_put_varint(p, tab->len[i]);
+    if (has_value) p = tb_put_varint(p, tb_zigzag(tab->vals[prev->val++].i));
+    prev->end = (uint64_t)tab->off[i] + tab->len[i];
+    return p;
+}
+
+/* Write tab, whose lexemes are spans of src, to out. names[0..ntypes) become
+   the type dictionary. Returns 0 if a name is longer than 255 bytes; write
+   errors are reported by ob_close(). */
+static int tokbin_write(OutBuf *out, const SymTable *tab, const char *src, size_t src_len,
+                        const char *const *names, unsigned ntypes) {
+    uint64_t dict_len = 0;
+    for (unsigned t = 0; t < ntypes; ++t) {
+        size_t n = strlen(names[t]);
+        if (n > 255) return 0;
+        dict_len += 1 + n;
+    }
+
+    /* the header carries the size of the token section, so measure it first */
+    uint8_t rec[TOKBIN_MAX_RECORD];
+    uint64_t tok_len = 0;
+    TokBinPrev prev = {0};
+    for (size_t i = 0; i < tab->count; ++i) tok_len += (uint64_t)(tb_encode(rec, tab, i, &prev) - rec);
+
+    uint8_t h[TOKBIN_HEADER] = {0};
+    memcpy(h, TOKBIN_MAGIC, sizeof(TOKBIN_MAGIC));
+    tb_put_u32(h + 8, TOKBIN_VERSION);
+    tb_put_u32(h + 12, ntypes);
+    tb_put_u64(h + 16, tab->count);
+    tb_put_u64(h + 24, TOKBIN_HEADER);
+    tb_put_u64(h + 32, TOKBIN_HEADER + dict_len);
+    tb_put_u64(h + 40, src_len);
+    tb_put_u64(h + 48, TOKBIN_HEADER + dict_len + src_len);
+    tb_put_u64(h + 56, tok_len);
+    ob_write(out, (const char *)h, sizeof(h));
+
+    for (unsigned t = 0; t < ntypes; ++t) {
+        size_t n = strlen(names[t]);
+        ob_putc(out, (char)n);
+        ob_write(out, names[t], n);
+    }
+    ob_write(out, src, src_len);
+
+    prev = (TokBinPrev){0};
+    for (size_t i = 0; i < tab->count; ++i) {
+        uint8_t *p = (uint8_t *)ob_reserve(out, TOKBIN_MAX_RECORD);
+        out->len += (size_t)(tb_encode(p, tab, i, &prev) - p);
+    }
+    return 1;
+}
+
+/* ---------- reading ---------- */
+
+typedef struct {
+    SourceBuf file;             // the whole .tok file, mapped when possible
+    uint32_t ntypes;
+    uint64_t ntokens;
+    const char *type_name[256]; // dictionary entries, not NUL-terminated
+    uint8_t type_len[256];
+    const char *str;            // string section (the source text)
+    uint64_t str_len;
+    const uint8_t *tok;         // token records
+    const uint8_t *tok_end;
+} TokBin;
+
+typedef struct {
+    uint8_t type;    // index into the type dictionary
+    uint8_t flags;
+    uint64_t off;    // lexeme = str[off, off + len)
+    uint64_t len;
+    LitValue value;  // if flags & TOKBIN_VALUE
+} TokBinToken;
+
+typedef struct {
+    const TokBin *tb;
+    const uint8_t *p;
+    uint64_t left;   // records not yet read
+    TokBinPrev prev;
+} TokBinIter;
+
+// check the header of data[0, len) and point tb into it; returns 0 if it is not a valid file
+static int tokbin_load(TokBin *tb, const void *data, size_t len) {
+    const uint8_t *d = data;
+    if (len < TOKBIN_HEADER || memcmp(d, TOKBIN_MAGIC, sizeof(TOKBIN_MAGIC)) != 0) return 0;
+    if (tb_get_u32(d + 8) != TOKBIN_VERSION) return 0;
+
+    uint32_t ntypes = tb_get_u32(d + 12);
+    uint64_t dict_off = tb_get_u64(d + 24), str_off = tb_get_u64(d + 32), str_len = tb_get_u64(d + 40);
+    uint64_t tok_off = tb_get_u64(d + 48), tok_len = tb_get_u64(d + 56);
+    if (ntypes > 256 || dict_off > len || str_off > len || str_len > len - str_off ||
+        tok_off > len || tok_len > len - tok_off)
+        return 0;
+
+    const uint8_t *p = d + dict_off, *dict_end = d + str_off;
+    for (uint32_t t = 0; t < ntypes; ++t) {
+        if (p >= dict_end || *p > dict_end - p - 1) return 0;
+        tb->type_len[t] = *p;
+        tb->type_name[t] = (const char *)p + 1;
+        p += 1 + *p;
+    }
+    tb->ntypes = ntypes;
+    tb->ntokens = tb_get_u64(d + 16);
+    tb->str = (const char *)d + str_off;
+    tb->str_len = str_len;
+    tb->tok = d + tok_off;
+    tb->tok_end = d + tok_off + tok_len;
+    return 1;
+}
+
+// open path ("-" = stdin); returns 0 if it cannot be read or is not a token file
+static int tokbin_open(TokBin *tb, const char *path) {
+    memset(tb, 0, sizeof(*tb));
+    if (!src_open(&tb->file, path)) return 0;
+    if (!tokbin_load(tb, tb->file.data, tb->file.len)) {
+        src_close(&tb->file);
+        return 0;
+    }
+    return 1;
+}
+
+static void tokbin_close(TokBin *tb) {
+    src_close(&tb->file);
+    memset(tb, 0, sizeof(*tb));
+}
+
+static void tokbin_iter_init(TokBinIter *it, const TokBin *tb) {
+    memset(it, 0, sizeof(*it));
+    it->tb = tb;
+    it->p = tb->tok;
+    it->left = tb->ntokens;
+}
+
+static inline int tb_get_varint(const uint8_t **pp, const uint8_t *end, uint64_t *v) {
+    const uint8_t *p = *pp;
+    uint64_t r = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t b = *p++;
+        r |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = r;
+            *pp = p;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// next token into *t: 1 = got one, 0 = end of the stream, -1 = the file is corrupt
+static int tokbin_next(TokBinIter *it, TokBinToken *t) {
+    if (it->left == 0) return 0;
+    const uint8_t *p = it->p, *end = it->tb->tok_end;
+    uint64_t doff, len;
+    if (end - p < 2) return -1;
+    t->type = p[0];
+    t->flags = p[1];
+    p += 2;
+    if (!tb_get_varint(&p, end, &doff) || !tb_get_varint(&p, end, &len)) return -1;
+    if (t->flags & TOKBIN_VALUE) {
+        uint64_t v;
+        if (!tb_get_varint(&p, end, &v)) return -1;
+        t->value.i = tb_unzigzag(v);
+    }
+
+    t->off = it->prev.end + (uint64_t)tb_unzigzag(doff);
+    t->len = len;
+    if (t->type >= it->tb->ntypes || t->off > it->tb->str_len || t->len > it->tb->str_len - t->off) return -1;
+
+    it->prev.end = t->off + t->len;
+    it->p = p;
+    it->left--;
+    return 1;
+}
+
+#endif // TOKBIN_H
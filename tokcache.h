@@ -0,0 +1,231 @@
+// On-disk token cache for --batch.
+// Each entry holds the token records of one source text, in tokbin.h's
+// record encoding, and is named after a 64-bit hash of the source bytes
+// seeded with LEXER_VERSION and TOKBIN_VERSION, so a lexer change never
+// serves stale tokens:
+//
+//     CACHE_DIR/0123456789abcdef.tc
+//
+//     header   48 bytes (integers little-endian)
+//                0  "SIMPTC\0\0"
+//                8  u32 LEXER_VERSION
+//               12  u32 TOKBIN_VERSION
+//               16  u64 source length
+//               24  u64 the hash the name is made of
+//               32  u64 a second hash of the source, seeded independently
+//               40  u64 ntokens
+//     tokens   ntokens tokbin records, to the end of the file
+//
+// The source itself is not stored: the caller has it anyway, to print the
+// lexemes. A hit is confirmed by the length and both hashes (128 bits), so
+// the source is hashed once per seed and never compared byte by byte.
+// Entries are written to a temporary name and renamed into place, so
+// concurrent runs sharing a cache never see half-written files.
+//
+// Nothing is evicted on its own: an edited file leaves its old entry
+// behind. tc_prune() removes every entry a run did not use (--cache-prune).
+
+#ifndef TOKCACHE_H
+#define TOKCACHE_H
+
+#include <dirent.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifndef PATH_MAX
+  #define PATH_MAX 1024
+#endif
+
+#ifdef _WIN32
+  #include <direct.h>
+  #define tc_mkdir(p) _mkdir(p)
+#else
+  #define tc_mkdir(p) mkdir((p), 0777)
+#endif
+
+#include "lexer.h"
+#include "tokbin.h"
+
+/* ---------- content hash ---------- */
+
+// 64-bit hash in the style of xxHash64: four multiply-rotate lanes over
+// 32-byte stripes, then the tail, then a final avalanche. Several GB/s.
+#define TC_P1 0x9E3779B185EBCA87ull
+#define TC_P2 0xC2B2AE3D27D4EB4Full
+#define TC_P3 0x165667B19E3779F9ull
+#define TC_P4 0x85EBCA77C2B2AE63ull
+#define TC_P5 0x27D4EB2F165667C5ull
+
+static inline uint64_t tc_rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t tc_read64(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t tc_round(uint64_t acc, uint64_t v) {
+    return tc_rotl(acc + v * TC_P2, 31) * TC_P1;
+}
+
+static inline uint64_t tc_merge(uint64_t h, uint64_t acc) {
+    return (h ^ tc_round(0, acc)) * TC_P1 + TC_P4;
+}
+
+static uint64_t tc_hash(const void *data, size_t len, uint64_t seed) {
+    const unsigned char *p = data, *end = p + len;
+    uint64_t h;
+    if (len >= 32) {
+        uint64_t a = seed + TC_P1 + TC_P2, b = seed + TC_P2, c = seed, d = seed - TC_P1;
+        do {
+            a = tc_round(a, tc_read64(p));
+            b = tc_round(b, tc_read64(p + 8));
+            c = tc_round(c, tc_read64(p + 16));
+            d = tc_round(d, tc_read64(p + 24));
+            p += 32;
+        } while (end - p >= 32);
+        h = tc_rotl(a, 1) + tc_rotl(b, 7) + tc_rotl(c, 12) + tc_rotl(d, 18);
+        h = tc_merge(tc_merge(tc_merge(tc_merge(h, a), b), c), d);
+    } else {
+        h = seed + TC_P5;
+    }
+    h += (uint64_t)len;
+    for (; end - p >= 8; p += 8) h = tc_rotl(h ^ tc_round(0, tc_read64(p)), 27) * TC_P1 + TC_P4;
+    for (; p < end; ++p) h = tc_rotl(h ^ (*p * TC_P5), 11) * TC_P1;
+    h ^= h >> 33;
+    h *= TC_P2;
+    h ^= h >> 29;
+    h *= TC_P3;
+    h ^= h >> 32;
+    return h;
+}
+
+/* ---------- entries ---------- */
+
+#define TC_SEED ((uint64_t)LEXER_VERSION << 32 | TOKBIN_VERSION)
+#define TC_SEED2 (TC_SEED ^ 0x5BD1E9955BD1E995ull)
+#define TC_MAGIC "SIMPTC"   // plus two NULs: 8 bytes
+#define TC_HEADER 48
+
+// what identifies a source text: its length and two independent hashes
+typedef struct {
+    uint64_t len, h1, h2;
+} TcKey;
+
+static void tc_key(TcKey *k, const char *src, size_t len) {
+    k->len = len;
+    k->h1 = tc_hash(src, len, TC_SEED);
+    k->h2 = tc_hash(src, len, TC_SEED2);
+}
+
+// path of the entry for k inside dir
+static void tc_entry_path(char *out, size_t cap, const char *dir, const TcKey *k) {
+    snprintf(out, cap, "%s/%016llx.tc", dir, (unsigned long long)k->h1);
+}
+
+// create dir if it does not exist yet; returns 0 if it still is not a directory
+static int tc_prepare_dir(const char *dir) {
+    struct stat st;
+    if (stat(dir, &st) == 0) return S_ISDIR(st.st_mode);
+    return tc_mkdir(dir) == 0 || (stat(dir, &st) == 0 && S_ISDIR(st.st_mode));
+}
+
+/* Open the entry at path if it was made from the source k describes, and
+   point tb at its tokens over src, that source. The type dictionary is the
+   lexer's own. Returns 0 on a miss; close a hit with tokbin_close(). */
+static int tc_lookup(TokBin *tb, const char *path, const TcKey *k, const char *src) {
+    memset(tb, 0, sizeof(*tb));
+    if (!src_open(&tb->file, path)) return 0;
+    const uint8_t *d = (const uint8_t *)tb->file.data;
+    size_t n = tb->file.len;
+    if (n < TC_HEADER || memcmp(d, TC_MAGIC "\0", 8) != 0 || tb_get_u32(d + 8) != LEXER_VERSION ||
+        tb_get_u32(d + 12) != TOKBIN_VERSION || tb_get_u64(d + 16) != k->len || tb_get_u64(d + 24) != k->h1 ||
+        tb_get_u64(d + 32) != k->h2) {
+        tokbin_close(tb);
+        return 0;
+    }
+    tb->ntypes = T_COUNT;
+    for (int t = 0; t < T_COUNT; ++t) {
+        tb->type_name[t] = token_names[t];
+        tb->type_len[t] = (uint8_t)strlen(token_names[t]);
+    }
+    tb->ntokens = tb_get_u64(d + 40);
+    tb->str = src;
+    tb->str_len = k->len;
+    tb->tok = d + TC_HEADER;
+    tb->tok_end = d + n;
+    return 1;
+}
+
+/* Store tab (lexed from the source k describes) at path. tag makes the
+   temporary name unique among writers running at the same time. Returns 0
+   on failure; a failed store only costs the next run a miss. */
+static int tc_store(const char *path, const char *tag, const SymTable *tab, const TcKey *k) {
+    char tmp[PATH_MAX + 128];
+    snprintf(tmp, sizeof(tmp), "%s.%s.tmp", path, tag);
+    OutBuf out;
+    if (!ob_open(&out, tmp)) return 0;
+
+    uint8_t h[TC_HEADER] = {0};
+    memcpy(h, TC_MAGIC, sizeof(TC_MAGIC));
+    tb_put_u32(h + 8, LEXER_VERSION);
+    tb_put_u32(h + 12, TOKBIN_VERSION);
+    tb_put_u64(h + 16, k->len);
+    tb_put_u64(h + 24, k->h1);
+    tb_put_u64(h + 32, k->h2);
+    tb_put_u64(h + 40, tab->count);
+    ob_write(&out, (const char *)h, sizeof(h));
+    TokBinPrev prev = {0};
+    for (size_t i = 0; i < tab->count; ++i) {
+        uint8_t *p = (uint8_t *)ob_reserve(&out, TOKBIN_MAX_RECORD);
+        out.len += (size_t)(tb_encode(p, tab, i, &prev) - p);
+    }
+
+    int ok = ob_close(&out);
+#ifdef _WIN32
+    if (ok) remove(path);   // rename() does not replace on Windows
+#endif
+    if (!ok || rename(tmp, path) != 0) {
+        remove(tmp);
+        return 0;
+    }
+    return 1;
+}
+
+static int tc_cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Remove the entries of dir that are not named after one of keep[0, n)
+   (which gets sorted), including ones from an older entry format (.tok).
+   Temporary files are left to the writers that own them. Returns the
+   number removed, or -1 if dir cannot be read. */
+static long tc_prune(const char *dir, uint64_t *keep, size_t n) {
+    DIR *d = opendir(dir);
+    if (!d) return -1;
+    if (n) qsort(keep, n, sizeof(*keep), tc_cmp_u64);
+    long removed = 0;
+    struct dirent *de;
+    while ((de = readdir(d)) != NULL) {
+        const char *name = de->d_name, *ext = name + 16;
+        if (strlen(name) < 17 || strspn(name, "0123456789abcdef") != 16 ||
+            (strcmp(ext, ".tc") != 0 && strcmp(ext, ".tok") != 0))
+            continue;
+        uint64_t h = strtoull(name, NULL, 16);
+        if (strcmp(ext, ".tc") == 0 && n && bsearch(&h, keep, n, sizeof(*keep), tc_cmp_u64)) continue;
+        char path[PATH_MAX + 32];
+        snprintf(path, sizeof(path), "%s/%s", dir, name);
+        removed += remove(path) == 0;
+    }
+    closedir(d);
+    return removed;
+}
+
+#endif // TOKCACHE_H
@@ -0,0 +1,109 @@
+// Trivia folding (--fold-trivia).
+// Whitespace, newline and comment tokens are not stored as rows. Each
+// significant token instead records where the trivia before it begins, so
+// its leading trivia is the source range
+//
+//     [lead[i], lexer_token_start(off[i], flags[i]))
+//
+// and whatever follows the last token is [tail, source length). Because
+// one scan starts where the previous one stopped, the ranges
+// [lead[i], lead[i + 1]) (with tail after the last token) tile the source:
+// each is the token's leading trivia and then its own text. That text
+// includes closing delimiters, so concatenating them gives back the source
+// byte for byte.
+//
+// The table only keeps per-type counts of the folded tokens (folded[]),
+// which is all the Token Summary needs.
+//
+// Folding happens either while lexing (fold_token() on each token, so the
+// trivia is never stored) or as a pass over a table that already holds it
+// (symtab_fold_trivia(), for the parallel lexer and the token cache).
+
+#ifndef TRIVIA_H
+#define TRIVIA_H
+
+#include "lexer.h"
+#include "symtab.h"
+
+static inline bool trivia_is(SymType t) {
+    return t == T_NEWLINE || t == T_WHITESPACE || t == T_COMMENT;
+}
+
+typedef struct {
+    size_t lead;    // start of the trivia seen since the last significant token ...
+    bool pending;   // ... if there was any
+} TriviaFold;
+
+static void fold_init(TriviaFold *f) {
+    f->lead = 0;
+    f->pending = false;
+}
+
+/* Feed the next token of type t starting at start (its lexer_token_start()).
+   Returns 1 with *lead set for a significant token, 0 for trivia. */
+static inline int fold_token(TriviaFold *f, SymType t, size_t start, size_t *lead) {
+    if (trivia_is(t)) {
+        if (!f->pending) {
+            f->lead = start;
+            f->pending = true;
+        }
+        return 0;
+    }
+    *lead = f->pending ? f->lead : start;
+    f->pending = false;
+    return 1;
+}
+
+// start of the trivia after the last token, once the input of length len has ended
+static inline size_t fold_tail(const TriviaFold *f, size_t len) {
+    return f->pending ? f->lead : len;
+}
+
+// give tab a lead column (before any token is pushed); returns 0 when out of memory
+static int symtab_enable_lead(SymTable *tab) {
+    tab->lead = malloc((tab->cap ? tab->cap : 1) * sizeof(*tab->lead));
+    return tab->lead != NULL;
+}
+
+// push a significant token of a folded table
+static int symtab_push_lead(SymTable *tab, uint8_t type, uint8_t flags, uint32_t off, uint32_t len, uint32_t lead) {
+    if (!symtab_push(tab, type, flags, off, len, type == T_LEX_ERROR)) return 0;
+    tab->lead[tab->count - 1] = lead;
+    return 1;
+}
+
+/* Fold the trivia rows out of a complete table of a source of length len,
+   in place. Does nothing if tab is folded already; returns 0 when out of memory. */
+static int symtab_fold_trivia(SymTable *tab, size_t len) {
+    if (tab->lead) return 1;
+    if (!symtab_enable_lead(tab)) return 0;
+    TriviaFold f;
+    fold_init(&f);
+    size_t n = 0, lead, v = 0;   // trivia has no values, so v only meets kept tokens
+    tab->errcount = 0;
+    for (size_t i = 0; i < tab->count; ++i) {
+        SymType t = (SymType)tab->type[i];
+        if (!fold_token(&f, t, lexer_token_start(tab->off[i], tab->flags[i]), &lead)) {
+            tab->folded[t]++;
+            continue;
+        }
+        tab->type[n] = tab->type[i];
+        tab->flags[n] = tab->flags[i];
+        tab->off[n] = tab->off[i];
+        tab->len[n] = tab->len[i];
+        tab->lead[n] = (uint32_t)lead;
+        if (t == T_LEX_ERROR) tab->errs[tab->errcount++] = (uint32_t)n;   // errors keep their order
+        if (v < tab->valcount && tab->vidx[v] == i) tab->vidx[v++] = (uint32_t)n;
+        n++;
+    }
+    tab->count = n;
+    tab->tail = (uint32_t)fold_tail(&f, len);
+    return 1;
+}
+
+// end of the source range that token i of a folded table owns (see above)
+static inline size_t trivia_extent_end(const SymTable *tab, size_t i) {
+    return i + 1 < tab->count ? tab->lead[i + 1] : tab->tail;
+}
+
+#endif // TRIVIA_H
@@ -0,0 +1,82 @@
+// SIMPLE word classifier. Generated by kwgen from keywords.txt - do not edit;
+// change the word list and run: ./kwgen keywords.txt > wordclass.h
+//
+// classify_word() takes an identifier-shaped lexeme (letters, digits, '_')
+// in any case and returns its class with a single hash probe.
+
+#ifndef WORDCLASS_H
+#define WORDCLASS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    WC_IDENT, WC_BOOL, WC_DATATYPE, WC_KEYWORD, WC_RESERVED, WC_NOISE
+} WordClass;
+
+#define WC_MIN_LEN 2
+#define WC_MAX_LEN 10
+#define WC_FIRST_LETTERS 0x00ef9ffu   // bit c-'a' set when a word starts with c
+
+static const struct {
+    char word[WC_MAX_LEN + 1];
+    uint8_t len;
+    uint8_t cls;
+} wc_table[128] = {
+    [  0] = { "main", 4, WC_RESERVED },
+    [  4] = { "do", 2, WC_KEYWORD },
+    [  6] = { "local", 5, WC_KEYWORD },
+    [ 11] = { "null", 4, WC_RESERVED },
+    [ 14] = { "then", 4, WC_NOISE },
+    [ 15] = { "return", 6, WC_KEYWORD },
+    [ 17] = { "char", 4, WC_DATATYPE },
+    [ 20] = { "to", 2, WC_NOISE },
+    [ 22] = { "collection", 10, WC_DATATYPE },
+    [ 24] = { "for", 3, WC_RESERVED },
+    [ 25] = { "get", 3, WC_KEYWORD },
+    [ 29] = { "to do", 5, WC_KEYWORD },
+    [ 30] = { "let", 3, WC_KEYWORD },
+    [ 31] = { "system", 6, WC_RESERVED },
+    [ 32] = { "error", 5, WC_RESERVED },
+    [ 35] = { "next", 4, WC_KEYWORD },
+    [ 36] = { "int", 3, WC_DATATYPE },
+    [ 37] = { "float", 5, WC_DATATYPE },
+    [ 39] = { "object", 6, WC_RESERVED },
+    [ 40] = { "timestamp", 9, WC_DATATYPE },
+    [ 41] = { "text", 4, WC_DATATYPE },
+    [ 58] = { "show", 4, WC_KEYWORD },
+    [ 63] = { "array", 5, WC_DATATYPE },
+    [ 74] = { "date", 4, WC_DATATYPE },
+    [ 76] = { "try", 3, WC_KEYWORD },
+    [ 79] = { "false", 5, WC_BOOL },
+    [ 80] = { "end", 3, WC_KEYWORD },
+    [ 83] = { "if", 2, WC_KEYWORD },
+    [ 84] = { "handle", 6, WC_KEYWORD },
+    [ 86] = { "else", 4, WC_KEYWORD },
+    [ 98] = { "time", 4, WC_DATATYPE },
+    [ 99] = { "secure", 6, WC_DATATYPE },
+    [103] = { "please", 6, WC_NOISE },
+    [107] = { "true", 4, WC_BOOL },
+    [111] = { "store", 5, WC_KEYWORD },
+    [121] = { "bool", 4, WC_DATATYPE },
+    [124] = { "string", 6, WC_DATATYPE },
+};
+
+static inline unsigned wc_hash(unsigned c0, unsigned c1, unsigned cl, size_t len) {
+    return (c0 * 1u + c1 * 1u + cl * 5u + (unsigned)len * 3u) & 127u;
+}
+
+/* '|0x20' folds A-Z onto a-z and leaves digits alone; '_' folds to 0x7f,
+   which no word contains, so it can never match by accident */
+static inline WordClass classify_word(const char *s, size_t len) {
+    if (len < WC_MIN_LEN || len > WC_MAX_LEN) return WC_IDENT;
+    unsigned c0 = (unsigned char)s[0] | 0x20u;
+    if (c0 - 'a' >= 26u || !((WC_FIRST_LETTERS >> (c0 - 'a')) & 1u)) return WC_IDENT;
+    unsigned h = wc_hash(c0, (unsigned char)s[1] | 0x20u, (unsigned char)s[len - 1] | 0x20u, len);
+    if (wc_table[h].len != len) return WC_IDENT;
+    for (size_t i = 0; i < len; ++i)
+        if (((unsigned char)s[i] | 0x20u) != (unsigned char)wc_table[h].word[i]) return WC_IDENT;
+    return (WordClass)wc_table[h].cls;
+}
+
+#endif // WORDCLASS_H